@@ -0,0 +1,111 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*
+* Counts heap allocations of the whole process, including cv::Mat buffers (cv::fastMalloc),
+* std containers and operator new, by replacing the allocation functions of the C library.
+* The replacements forward to the glibc implementations, so counting is available on
+* Linux (glibc) only.
+*/
+
+
+/* Include files */
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include "AllocationCounter.h"
+
+/* Global variables */
+static std::atomic<uint64_t> allocationCount{ 0 };
+static std::atomic<uint64_t> allocationBytes{ 0 };
+
+/*! Record one allocation. */
+static inline void countAllocation(size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocationBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+/*! Check if an alignment is a power of two. */
+static inline bool isPowerOfTwo(size_t alignment) {
+	return (alignment != 0) && ((alignment & (alignment - 1)) == 0);
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+	void* __libc_malloc(size_t size);
+	void* __libc_calloc(size_t count, size_t size);
+	void* __libc_realloc(void* pointer, size_t size);
+	void* __libc_memalign(size_t alignment, size_t size);
+
+	void* malloc(size_t size) {
+		countAllocation(size);
+		return __libc_malloc(size);
+	}
+
+	void* calloc(size_t count, size_t size) {
+		countAllocation(count * size);
+		return __libc_calloc(count, size);
+	}
+
+	void* realloc(void* pointer, size_t size) {
+		countAllocation(size);
+		return __libc_realloc(pointer, size);
+	}
+
+	void* memalign(size_t alignment, size_t size) {
+		countAllocation(size);
+		return __libc_memalign(alignment, size);
+	}
+
+	// Invalid alignments fail like in glibc (and are not counted): aligned_alloc() requires a
+	// power of two, posix_memalign() additionally a multiple of sizeof(void*).
+	void* aligned_alloc(size_t alignment, size_t size) {
+		if (!isPowerOfTwo(alignment)) {
+			errno = EINVAL;
+			return nullptr;
+		}
+		countAllocation(size);
+		return __libc_memalign(alignment, size);
+	}
+
+	int posix_memalign(void** pointer, size_t alignment, size_t size) {
+		if (!isPowerOfTwo(alignment) || (alignment % sizeof(void*) != 0))
+			return EINVAL;
+
+		countAllocation(size);
+		void* memory = __libc_memalign(alignment, size);
+
+		if (memory == nullptr)
+			return ENOMEM;
+		*pointer = memory;
+		return 0;
+	}
+}
+#endif
+
+/*! Check if allocations are counted on this platform.
+*
+* \return true, if getAllocationCount() returns the number of allocations
+*/
+bool isAllocationCounterAvailable() {
+#if defined(__GLIBC__)
+	return true;
+#else
+	return false;
+#endif
+}
+
+/*! Get the number and size of heap allocations since program start.
+*
+* Take the difference of two calls to count the allocations of a code section.
+*
+* \return allocations of all threads
+*/
+AllocationCount getAllocationCount() {
+	AllocationCount result;
+
+	result.count = allocationCount.load(std::memory_order_relaxed);
+	result.bytes = allocationBytes.load(std::memory_order_relaxed);
+	return result;
+}
@@ -0,0 +1,24 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_ALLOCATION_COUNTER_H
+#define IP_ALLOCATION_COUNTER_H
+
+/* Include files */
+#include <cstdint>						// Declare uint64_t
+
+/*! Number and size of heap allocations since program start. */
+struct AllocationCount {
+	uint64_t count = 0;
+	uint64_t bytes = 0;
+};
+
+bool isAllocationCounterAvailable();
+AllocationCount getAllocationCount();
+
+#endif /* IP_ALLOCATION_COUNTER_H */
@@ -0,0 +1,520 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*
+* Headless benchmark suite of the ip:: kernels of the exercises and labs on synthetic test
+* patterns (ip::patterns), so neither the ImagingData folder nor a display is needed.
+* Every kernel runs for all image sizes and thread counts. Reported are the runtime, the
+* throughput in Mpix/s and the heap allocations per iteration (Linux/glibc only). Results
+* can be written as JSON to compare releases. If the ImagingData folder is found, the Hough
+* transform additionally runs on the photos of the Hough lab at the lab resolution.
+*
+* Build (Linux, from this folder):
+*   g++ -std=c++17 -O2 -I../Exercise/Shared -I../Exercise/06_Binary/Shared -I../Exercise/07_Features/Shared \
+*       -I../Exercise/08_Fourier/Shared -I"../Labore/P2 Hough transform" -I"../Labore/P3 Shared (dice)" \
+*       [A-Z]*.cpp Kernels/[A-Z]*.cpp ../Exercise/Shared/[A-Z]*.cpp \
+*       ../Exercise/06_Binary/Shared/[A-Z]*.cpp ../Exercise/07_Features/Shared/[A-Z]*.cpp \
+*       ../Exercise/08_Fourier/Shared/[A-Z]*.cpp "../Labore/P2 Hough transform/"{Sobel,HoughLine}.cpp \
+*       "../Labore/P3 Shared (dice)/"[A-Z]*.cpp $(pkg-config --cflags --libs opencv4) -lpthread -o benchmark
+*
+* Usage:
+*   ./benchmark [--sizes=1,4,12,24,50] [--threads=1,8] [--filter=text] [--json=file]
+*
+*   --sizes    Image sizes in megapixels (default: 1, 4, 12, 24, 50)
+*   --threads  Thread counts (default: 1 and one thread per core)
+*   --filter   Run benchmarks whose name contains the text, only
+*   --json     Write results to a JSON file
+*   --data     ImagingData folder (default: environment variable ImagingData or ../ImagingData)
+*/
+
+
+/* Compiler settings */
+#define _CRT_SECURE_NO_WARNINGS		// Enable getenv()
+
+
+/* Include files */
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "AllocationCounter.h"
+#include "DiceDetection.h"
+#include "EdgeList.h"
+#include "ExerciseKernels.h"
+#include "Fourier.h"
+#include "HoughLine.h"
+#include "Parallel.h"
+#include "Patterns.h"
+#include "Simd.h"
+#include "Sobel.h"
+#include "TemplateMatching.h"
+#include "Thresholding.h"
+
+/* Defines */
+#define BENCHMARK_MIN_TIME_MS 200.0		// Repeat a kernel until this time has passed ...
+#define BENCHMARK_MAX_ITERATIONS 20		// ... or this number of iterations is reached
+#define BENCHMARK_SEED 42				// Seed of the random patterns
+#define BENCHMARK_NOISE_SIGMA 8.0		// Gaussian noise added to the gray-value pattern
+#define BENCHMARK_EDGE_THRESHOLD 25		// Threshold of the Sobel image for the Hough transform
+#define BENCHMARK_TEMPLATE_SIZE 15		// Object size of template matching
+#define IMAGE_DATA_PATH getenv("ImagingData")			// Read environment variable ImagingData
+#define DEFAULT_IMAGE_DATA_PATH "../ImagingData"		// ImagingData folder of the repository
+
+/* Namespaces */
+using namespace std;
+
+/* Datatypes */
+/*! Input images of one size (synthetic patterns). */
+struct Inputs {
+	cv::Mat gray;			// Sinusoidal grating with Gaussian noise
+	cv::Mat binary;			// Checkerboard with values {0, 1}
+	cv::Mat labels;			// Labeled checkerboard
+	cv::Mat edges;			// Thresholded Sobel image of the grating
+	cv::Mat dice;			// Bright dice with dark pips on dark background
+};
+
+/*! Benchmarked kernel. */
+struct Kernel {
+	string name;												// Kernel and parameters
+	double maxMegapixels;										// Largest image size to run (slow kernels)
+	function<const cv::Mat&(const Inputs&)> input;				// Input image
+	function<void(const cv::Mat&, cv::Mat&)> prepare;			// Called before every run, not measured (may be empty)
+	function<void(const cv::Mat&, cv::Mat&)> run;				// Measured kernel
+};
+
+/*! Result of one benchmark. */
+struct Result {
+	string name;
+	cv::Size size;
+	int threads;
+	int iterations;
+	double meanMs, minMs;
+	double allocations, allocatedBytes;		// Per iteration
+};
+
+/* Prototypes */
+vector<Kernel> createKernels();
+vector<Kernel> createPhotoKernels(const string& photoName);
+void createInputs(cv::Size size, Inputs& inputs);
+void createDiceImage(cv::Size size, cv::Mat& image);
+Result runKernel(const Kernel& kernel, const cv::Mat& input, int threads);
+cv::Size imageSize(double megapixels);
+vector<double> parseList(const string& text);
+void printResult(const Result& result);
+void writeJson(const string& filePath, const vector<Result>& results);
+
+/* Main function */
+int main(int argc, char* argv[])
+{
+	vector<double> megapixels = { 1, 4, 12, 24, 50 };
+	vector<double> threadCounts = { 1, (double)max(thread::hardware_concurrency(), 1u) };
+	string filter, jsonPath;
+	string imageDataPath = IMAGE_DATA_PATH ? IMAGE_DATA_PATH : DEFAULT_IMAGE_DATA_PATH;
+
+	// Parse options
+	for (int i = 1; i < argc; i++) {
+		string option = argv[i];
+
+		if (option.rfind("--sizes=", 0) == 0)
+			megapixels = parseList(option.substr(8));
+		else if (option.rfind("--threads=", 0) == 0)
+			threadCounts = parseList(option.substr(10));
+		else if (option.rfind("--filter=", 0) == 0)
+			filter = option.substr(9);
+		else if (option.rfind("--json=", 0) == 0)
+			jsonPath = option.substr(7);
+		else if (option.rfind("--data=", 0) == 0)
+			imageDataPath = option.substr(7);
+		else {
+			cout << "[ERROR] Unknown option: " << option << endl;
+			return 1;
+		}
+	}
+	sort(threadCounts.begin(), threadCounts.end());
+	threadCounts.erase(unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+	const char* simdNames[] = { "none", "SSE2", "AVX2" };
+	cout << "SIMD: " << simdNames[ip::getSimdLevel()] << ", allocation counter: "
+		<< (isAllocationCounterAvailable() ? "on" : "off") << endl;
+	cout << left << setw(40) << "Benchmark" << setw(12) << "Size" << setw(8) << "Threads" << setw(8) << "Iter"
+		<< setw(12) << "Mean [ms]" << setw(12) << "Min [ms]" << setw(10) << "Mpix/s" << setw(10) << "Allocs" << "Bytes" << endl;
+
+	vector<Kernel> kernels = createKernels();
+	vector<Result> results;
+
+	for (double mp : megapixels) {
+		cv::Size size = imageSize(mp);
+		Inputs inputs;
+
+		createInputs(size, inputs);
+		for (const Kernel& kernel : kernels) {
+			if ((kernel.name.find(filter) == string::npos) || (mp > kernel.maxMegapixels))
+				continue;
+
+			for (double threads : threadCounts) {
+				results.push_back(runKernel(kernel, kernel.input(inputs), (int)threads));
+				printResult(results.back());
+			}
+		}
+	}
+
+	// Photos of the Hough lab (skipped without ImagingData)
+	for (const string photoName : { "Cologne.jpg", "Docks.jpg" }) {
+		cv::Mat photo = cv::imread(imageDataPath + "/Images/" + photoName, cv::IMREAD_GRAYSCALE);
+
+		if (photo.empty()) {
+			cout << "[WARNING] Cannot open image: " << imageDataPath << "/Images/" << photoName << endl;
+			continue;
+		}
+
+		for (const Kernel& kernel : createPhotoKernels(photoName)) {
+			if (kernel.name.find(filter) == string::npos)
+				continue;
+
+			for (double threads : threadCounts) {
+				results.push_back(runKernel(kernel, photo, (int)threads));
+				printResult(results.back());
+			}
+		}
+	}
+
+	if (!jsonPath.empty())
+		writeJson(jsonPath, results);
+	return 0;
+}
+
+/*! Create the list of benchmarked kernels.
+*
+* \return kernels
+*/
+vector<Kernel> createKernels()
+{
+	auto gray = [](const Inputs& inputs) -> const cv::Mat& { return inputs.gray; };
+	auto binary = [](const Inputs& inputs) -> const cv::Mat& { return inputs.binary; };
+	auto labels = [](const Inputs& inputs) -> const cv::Mat& { return inputs.labels; };
+	auto edges = [](const Inputs& inputs) -> const cv::Mat& { return inputs.edges; };
+	auto dice = [](const Inputs& inputs) -> const cv::Mat& { return inputs.dice; };
+	auto copy = [](const cv::Mat& input, cv::Mat& output) { input.copyTo(output); };
+	auto edgeList = make_shared<ip::EdgeList>();
+	auto findEdges = [edgeList](const cv::Mat& input, cv::Mat&) {
+		if (edgeList->imageSize != input.size())
+			ip::findEdgePixels(input, *edgeList);
+	};
+	auto peakEdgeList = make_shared<ip::EdgeList>();
+	auto peakHoughSpace = make_shared<cv::Mat>();
+	auto transformEdges = [peakEdgeList, peakHoughSpace](const cv::Mat& input, cv::Mat&) {
+		if (peakEdgeList->imageSize != input.size()) {
+			ip::findEdgePixels(input, *peakEdgeList);
+			ip::houghTransform(*peakEdgeList, *peakHoughSpace, 721, 720);
+		}
+	};
+	auto directedEdgeList = make_shared<ip::EdgeList>();
+	auto findDirectedEdges = [directedEdgeList](const cv::Mat& input, cv::Mat&) {
+		if (directedEdgeList->imageSize != input.size()) {
+			cv::Mat sobel;
+			ip::sobelFilter(input, sobel, ip::SOBEL_L2, NULL, NULL, BENCHMARK_EDGE_THRESHOLD, directedEdgeList.get());
+		}
+	};
+
+	return {
+		{ "boxFilter/7x7", HUGE_VAL, gray, nullptr,
+			[](const cv::Mat& input, cv::Mat& output) { boxFilter(input, output, 7); } },
+		{ "boxFilter/31x31", HUGE_VAL, gray, nullptr,
+			[](const cv::Mat& input, cv::Mat& output) { boxFilter(input, output, 31); } },
+		{ "binomialFilter3x3", HUGE_VAL, gray, nullptr,
+			[](const cv::Mat& input, cv::Mat& output) { binomialFilter3x3(input, output); } },
+		{ "minMaxFilter/15x15", HUGE_VAL, gray, nullptr,
+			[maxImage = cv::Mat()](const cv::Mat& input, cv::Mat& output) mutable { minMaxFilter(input, output, maxImage, cv::Size(15, 15)); } },
+		{ "sobelFilter", HUGE_VAL, gray, nullptr,
+			[](const cv::Mat& input, cv::Mat& output) { ip::sobelFilter(input, output); } },
+		{ "sobelFilter/L1", HUGE_VAL, gray, nullptr,
+			[](const cv::Mat& input, cv::Mat& output) { ip::sobelFilter(input, output, ip::SOBEL_L1); } },
+		{ "sobelFilter/direction+edges", HUGE_VAL, gray, nullptr,
+			[direction = cv::Mat(), edges = cv::Mat()](const cv::Mat& input, cv::Mat& output) mutable {
+				ip::sobelFilter(input, output, ip::SOBEL_L2, &direction, &edges, BENCHMARK_EDGE_THRESHOLD);
+			} },
+		{ "sobelFilter/edgeList", HUGE_VAL, gray, nullptr,
+			[list = ip::EdgeList()](const cv::Mat& input, cv::Mat& output) mutable {
+				ip::sobelFilter(input, output, ip::SOBEL_L2, NULL, NULL, BENCHMARK_EDGE_THRESHOLD, &list);
+			} },
+		{ "gradient", HUGE_VAL, gray, nullptr,
+			[gradX = cv::Mat(), gradY = cv::Mat()](const cv::Mat& input, cv::Mat& output) mutable { gradient(input, output, gradX, gradY); } },
+		{ "houghTransform/721x720", 12, edges, nullptr,
+			[](const cv::Mat& input, cv::Mat& output) { ip::houghTransform(input, output, 721, 720); } },
+		{ "houghTransform/edgeList/721x720", 12, edges, findEdges,
+			[edgeList](const cv::Mat&, cv::Mat& output) { ip::houghTransform(*edgeList, output, 721, 720); } },
+		{ "houghTransform/edgeList/721x720/+-5deg", 12, gray, findDirectedEdges,
+			[directedEdgeList](const cv::Mat&, cv::Mat& output) { ip::houghTransform(*directedEdgeList, output, 721, 720, 5.0); } },
+		{ "houghPeaks/721x720/10", 12, edges, transformEdges,
+			[peakHoughSpace, peaks = vector<ip::houghPeak>()](const cv::Mat& input, cv::Mat&) mutable {
+				ip::houghPeaks(*peakHoughSpace, input.size(), peaks, 10);
+			} },
+		{ "findEdgePixels", HUGE_VAL, edges, nullptr,
+			[list = ip::EdgeList()](const cv::Mat& input, cv::Mat&) mutable { ip::findEdgePixels(input, list); } },
+		{ "bernsenThreshold/r7", HUGE_VAL, gray, nullptr,
+			[](const cv::Mat& input, cv::Mat& output) { ip::bernsenThreshold(input, output, 7, 15); } },
+		{ "isodataThreshold", HUGE_VAL, gray, nullptr,
+			[](const cv::Mat& input, cv::Mat& output) { ip::isodataThreshold(input, output); } },
+		{ "labelRegions", HUGE_VAL, binary, copy,
+			[](const cv::Mat&, cv::Mat& output) { ip::labelRegions(output); } },
+		{ "labels2BlobFeatures", HUGE_VAL, labels, nullptr,
+			[](const cv::Mat& input, cv::Mat&) { countBlobFeatures(input); } },
+		{ "templateMatching/15x15", 4, gray, nullptr,
+			[](const cv::Mat& input, cv::Mat& output) {
+				cv::Point bestMatch;
+				cv::Mat object = input(cv::Rect(input.cols / 2, input.rows / 2, BENCHMARK_TEMPLATE_SIZE, BENCHMARK_TEMPLATE_SIZE));
+				ip::templateMatching(input, object, output, bestMatch);
+			} },
+		{ "fourierTransform", HUGE_VAL, gray, nullptr,
+			[freqDomain = ip::fourier()](const cv::Mat& input, cv::Mat&) mutable { ip::fourierTransform(input, freqDomain); } },
+		{ "dicePipeline", HUGE_VAL, dice, nullptr,
+			[](const cv::Mat& input, cv::Mat& output) {
+				vector<ip::blob> dices, pips;
+				cv::Mat pipLabels;
+				ip::locateDices(input, output, dices);
+				for (const ip::blob& die : dices)
+					ip::locateDicePips(input(die.boundingBox), pipLabels, pips);
+			} },
+	};
+}
+
+/*! Create the kernels benchmarked on a photo (input: gray-value photo).
+*
+* The Hough transform runs at the resolution of the Hough lab (721 x 720) on the edge list
+* of the Sobel image, which is calculated in the unmeasured preparation.
+*
+* \param photoName File name of the photo (part of the kernel names)
+* \return kernels
+*/
+vector<Kernel> createPhotoKernels(const string& photoName)
+{
+	auto gray = [](const Inputs& inputs) -> const cv::Mat& { return inputs.gray; };
+	auto edgeList = make_shared<ip::EdgeList>();
+	auto findEdges = [edgeList](const cv::Mat& input, cv::Mat&) {
+		if (edgeList->imageSize != input.size()) {
+			cv::Mat sobel;
+			ip::sobelFilter(input, sobel, ip::SOBEL_L2, NULL, NULL, BENCHMARK_EDGE_THRESHOLD, edgeList.get());
+		}
+	};
+
+	return {
+		{ "houghTransform/" + photoName + "/721x720", HUGE_VAL, gray, findEdges,
+			[edgeList](const cv::Mat&, cv::Mat& output) { ip::houghTransform(*edgeList, output, 721, 720); } },
+		{ "houghTransform/" + photoName + "/721x720/+-5deg", HUGE_VAL, gray, findEdges,
+			[edgeList](const cv::Mat&, cv::Mat& output) { ip::houghTransform(*edgeList, output, 721, 720, 5.0); } },
+	};
+}
+
+/*! Create the input patterns of one image size.
+*
+* \param size Image size
+* \param inputs [out] Input images
+*/
+void createInputs(cv::Size size, Inputs& inputs)
+{
+	// Gray values: grating with noise (all gray values occur, edges in all rows)
+	ip::patterns::sinusoid(inputs.gray, size, CV_8U, 32.0, 30.0);
+	ip::patterns::addGaussianNoise(inputs.gray, BENCHMARK_NOISE_SIGMA, BENCHMARK_SEED);
+
+	// Binary regions: checkerboard with about 50 white cells (labels of uchar images end at 255)
+	ip::patterns::checkerboard(inputs.binary, size, CV_8U, max(max(size.width, size.height) / 10, 1));
+	inputs.binary /= 255;
+	inputs.binary.copyTo(inputs.labels);
+	ip::labelRegions(inputs.labels);
+
+	// Edges
+	cv::Mat sobel;
+	ip::sobelFilter(inputs.gray, sobel, ip::SOBEL_L2, NULL, &inputs.edges, BENCHMARK_EDGE_THRESHOLD);
+
+	createDiceImage(size, inputs.dice);
+}
+
+/*! Create an image of 12 dice showing 1 to 6 pips.
+*
+* \param size Image size
+* \param image [out] Dice image (CV_8U)
+*/
+void createDiceImage(cv::Size size, cv::Mat& image)
+{
+	// Pip positions on a 3x3 grid for 1 .. 6 pips
+	const int pips[6][9] = {
+		{ 0, 0, 0, 0, 1, 0, 0, 0, 0 }, { 1, 0, 0, 0, 0, 0, 0, 0, 1 }, { 1, 0, 0, 0, 1, 0, 0, 0, 1 },
+		{ 1, 0, 1, 0, 0, 0, 1, 0, 1 }, { 1, 0, 1, 0, 1, 0, 1, 0, 1 }, { 1, 0, 1, 1, 0, 1, 1, 0, 1 } };
+	int cellWidth = size.width / 4, cellHeight = size.height / 3;
+	int dieSize = min(cellWidth, cellHeight) * 2 / 3, pipSize = dieSize / 6;
+
+	image.create(size, CV_8U);
+	image = 40;
+	for (int i = 0; i < 12; i++) {
+		cv::Rect die((i % 4) * cellWidth + (cellWidth - dieSize) / 2, (i / 4) * cellHeight + (cellHeight - dieSize) / 2, dieSize, dieSize);
+		image(die) = 220;
+
+		for (int p = 0; p < 9; p++) {
+			if (pips[i % 6][p])
+				image(cv::Rect(die.x + (p % 3 * 2 + 1) * dieSize / 6 - pipSize / 2, die.y + (p / 3 * 2 + 1) * dieSize / 6 - pipSize / 2, pipSize, pipSize)) = 30;
+		}
+	}
+	ip::patterns::addGaussianNoise(image, BENCHMARK_NOISE_SIGMA, BENCHMARK_SEED);
+}
+
+/*! Measure a kernel.
+*
+* After a warm-up run (allocating the outputs), the kernel is repeated until
+* BENCHMARK_MIN_TIME_MS has passed or BENCHMARK_MAX_ITERATIONS is reached.
+* Allocations are counted during the measured runs, i. e., the steady state of a
+* kernel processing a video.
+*
+* \param kernel Kernel to measure
+* \param input Input image
+* \param threads Number of threads
+* \return measured runtimes and allocations
+*/
+Result runKernel(const Kernel& kernel, const cv::Mat& input, int threads)
+{
+	Result result;
+	cv::Mat output;
+	double totalMs = 0.0;
+
+	ip::setNumThreads(threads);
+	result.name = kernel.name;
+	result.size = input.size();
+	result.threads = threads;
+	result.iterations = 0;
+	result.minMs = HUGE_VAL;
+	result.allocations = 0.0;
+	result.allocatedBytes = 0.0;
+
+	for (int i = -1; (i < BENCHMARK_MAX_ITERATIONS) && ((i < 1) || (totalMs < BENCHMARK_MIN_TIME_MS)); i++) {
+		if (kernel.prepare)
+			kernel.prepare(input, output);
+
+		AllocationCount before = getAllocationCount();
+		int64 start = cv::getTickCount();
+		kernel.run(input, output);
+		double ms = 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency();
+		AllocationCount after = getAllocationCount();
+
+		// Skip warm-up run
+		if (i < 0)
+			continue;
+
+		totalMs += ms;
+		result.minMs = min(result.minMs, ms);
+		result.allocations += (double)(after.count - before.count);
+		result.allocatedBytes += (double)(after.bytes - before.bytes);
+		result.iterations++;
+	}
+
+	result.meanMs = totalMs / result.iterations;
+	result.allocations /= result.iterations;
+	result.allocatedBytes /= result.iterations;
+	return result;
+}
+
+/*! Size of a 4:3 image with a given number of pixels.
+*
+* \param megapixels Number of pixels in millions
+* \return image size (width is a multiple of 16)
+*/
+cv::Size imageSize(double megapixels)
+{
+	double pixels = max(megapixels, 0.01) * 1e6;
+	int width = max(16, (int)(sqrt(pixels * 4.0 / 3.0) / 16.0 + 0.5) * 16);
+
+	return cv::Size(width, max(1, (int)(pixels / width + 0.5)));
+}
+
+/*! Parse a comma-separated list of numbers.
+*
+* \param text List, e. g., "1,4,12"
+* \return numbers
+*/
+vector<double> parseList(const string& text)
+{
+	vector<double> values;
+	stringstream stream(text);
+	string item;
+
+	while (getline(stream, item, ','))
+		values.push_back(atof(item.c_str()));
+	return values;
+}
+
+/*! Print one line of the result table.
+*
+* \param result Benchmark result
+*/
+void printResult(const Result& result)
+{
+	cout << left << setw(40) << result.name
+		<< setw(12) << (to_string(result.size.width) + "x" + to_string(result.size.height))
+		<< setw(8) << result.threads << setw(8) << result.iterations
+		<< fixed << setprecision(2) << setw(12) << result.meanMs << setw(12) << result.minMs
+		<< setprecision(1) << setw(10) << (result.size.area() / 1e6) / (result.minMs / 1000.0)
+		<< setprecision(0) << setw(10) << result.allocations << result.allocatedBytes << endl;
+}
+
+/*! Write results to a JSON file (one entry per kernel, image size and thread count).
+*
+* \param filePath Path of the JSON file
+* \param results Benchmark results
+*/
+void writeJson(const string& filePath, const vector<Result>& results)
+{
+	ofstream file(filePath);
+
+	if (!file.is_open()) {
+		cout << "[ERROR] Cannot write file: " << filePath << endl;
+		return;
+	}
+
+	char date[32];
+	time_t now = time(nullptr);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+	const char* simdNames[] = { "none", "SSE2", "AVX2" };
+	file << "{" << endl;
+	file << "  \"context\": {" << endl;
+	file << "    \"date\": \"" << date << "\"," << endl;
+	file << "    \"num_cpus\": " << thread::hardware_concurrency() << "," << endl;
+	file << "    \"simd\": \"" << simdNames[ip::getSimdLevel()] << "\"," << endl;
+	file << "    \"allocation_counter\": " << (isAllocationCounterAvailable() ? "true" : "false") << endl;
+	file << "  }," << endl;
+	file << "  \"benchmarks\": [" << endl;
+
+	file << fixed;
+	for (size_t i = 0; i < results.size(); i++) {
+		const Result& result = results[i];
+		string size = to_string(result.size.width) + "x" + to_string(result.size.height);
+
+		file << "    {" << endl;
+		file << "      \"name\": \"" << result.name << "/" << size << "/threads:" << result.threads << "\"," << endl;
+		file << "      \"kernel\": \"" << result.name << "\"," << endl;
+		file << "      \"width\": " << result.size.width << "," << endl;
+		file << "      \"height\": " << result.size.height << "," << endl;
+		file << "      \"threads\": " << result.threads << "," << endl;
+		file << "      \"iterations\": " << result.iterations << "," << endl;
+		file << setprecision(4) << "      \"mean_time_ms\": " << result.meanMs << "," << endl;
+		file << "      \"min_time_ms\": " << result.minMs << "," << endl;
+		file << setprecision(2) << "      \"mpix_per_s\": " << (result.size.area() / 1e6) / (result.minMs / 1000.0) << "," << endl;
+		file << "      \"allocations_per_iteration\": " << result.allocations << "," << endl;
+		file << "      \"allocated_bytes_per_iteration\": " << result.allocatedBytes << endl;
+		file << "    }" << ((i + 1 < results.size()) ? "," : "") << endl;
+	}
+
+	file << "  ]" << endl;
+	file << "}" << endl;
+	cout << "Results written to " << filePath << endl;
+}
@@ -0,0 +1,32 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_EXERCISE_KERNELS_H
+#define IP_EXERCISE_KERNELS_H
+
+/* Include files */
+#include <opencv2/core/core.hpp>
+#include "BorderAccessor.h"
+#include "IntegralImage.h"
+
+/* Prototypes */
+// Kernels defined in exercise main files (linked by Kernels/*Kernel.cpp)
+void boxFilter(const cv::Mat& image, cv::Mat& filtered, int kernelSize, ip::BorderMode border = ip::BORDER_CLAMP);
+void boxFilter(const cv::Mat& image, const ip::IntegralImage& integral, cv::Mat& filtered, int kernelSize);
+void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered, ip::BorderMode border = ip::BORDER_CLAMP);
+void minMaxFilter(const cv::Mat& image, cv::Mat& minImage, cv::Mat& maxImage, cv::Size kernelSize, ip::BorderMode border = ip::BORDER_CLAMP);
+void gradient(const cv::Mat& image, cv::Mat& gradAbs, cv::Mat& gradX, cv::Mat& gradY);
+int countBlobFeatures(const cv::Mat& labelImage);
+
+namespace ip
+{
+	// Region labeling of exercise 06_Binary/FloodFill (the dice lab has another overload)
+	void labelRegions(cv::Mat& binImage);
+}
+
+#endif /* IP_EXERCISE_KERNELS_H */
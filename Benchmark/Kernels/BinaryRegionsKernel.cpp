@@ -0,0 +1,34 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*
+* Kernels labelRegions() and labels2BlobFeatures() of exercise 06_Binary/FloodFill.
+* The exercise is compiled unchanged. Its BLOB type and the functions also defined by the
+* dice lab (Labore/P3 Shared (dice)) are renamed, so both can be linked into the benchmark.
+*/
+
+
+/* Defines */
+#define blob floodFillBlob
+#define labels2RGB floodFillLabels2RGB
+#define annotateBlobs floodFillAnnotateBlobs
+
+/* Include files */
+#include "../../Exercise/06_Binary/FloodFill/BinaryRegions.cpp"
+#include "../ExerciseKernels.h"
+
+/*! Gather BLOB features of a labeled image by ip::labels2BlobFeatures().
+*
+* \param labelImage [in] Labeled image (labels 1 .. 255)
+* \return number of labels found
+*/
+int countBlobFeatures(const cv::Mat& labelImage) {
+	ip::blob blobs[256];
+	int count = 0;
+
+	ip::labels2BlobFeatures(labelImage, blobs);
+	for (int label = 1; label < 256; label++)
+		count += (blobs[label].size > 0);
+	return count;
+}
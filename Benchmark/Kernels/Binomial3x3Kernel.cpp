@@ -0,0 +1,15 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*
+* Kernel binomialFilter3x3() of exercise 04_Filter/Binomial3x3.
+* The exercise is compiled unchanged, its main() is renamed so it can be linked into the benchmark.
+*/
+
+
+/* Defines */
+#define main binomial3x3ExerciseMain
+
+/* Include files */
+#include "../../Exercise/04_Filter/Binomial3x3/Binomial3x3.cpp"
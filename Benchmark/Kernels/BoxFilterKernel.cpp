@@ -0,0 +1,15 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*
+* Kernels boxFilter() of exercise 04_Filter/BoxFilter.
+* The exercise is compiled unchanged, its main() is renamed so it can be linked into the benchmark.
+*/
+
+
+/* Defines */
+#define main boxFilterExerciseMain
+
+/* Include files */
+#include "../../Exercise/04_Filter/BoxFilter/BoxFilter.cpp"
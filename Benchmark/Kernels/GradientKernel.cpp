@@ -0,0 +1,15 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*
+* Kernel gradient() of exercise 05_Edges/Gradient.
+* The exercise is compiled unchanged, its main() is renamed so it can be linked into the benchmark.
+*/
+
+
+/* Defines */
+#define main gradientExerciseMain
+
+/* Include files */
+#include "../../Exercise/05_Edges/Gradient/Gradient.cpp"
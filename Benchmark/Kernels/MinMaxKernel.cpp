@@ -0,0 +1,15 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*
+* Kernel minMaxFilter() of exercise 04_Filter/MinMax.
+* The exercise is compiled unchanged, its main() is renamed so it can be linked into the benchmark.
+*/
+
+
+/* Defines */
+#define main minMaxExerciseMain
+
+/* Include files */
+#include "../../Exercise/04_Filter/MinMax/MinMax.cpp"
@@ -0,0 +1,25 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*
+* Kernels of 06_Binary/Shared (thresholding and the histograms it uses) for the oracle.
+* Histogram.cpp and 03_PointOps/HistoEqualization/iputils.cpp both define ip::max(), so the
+* helper of Histogram.cpp is renamed here to link both into one program.
+*/
+
+
+/* Include files */
+#include <iostream>
+#include <vector>
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "HistogramKernel.h"
+
+/* Defines */
+#define max binaryHistogramMax
+#include "../../Exercise/06_Binary/Shared/Histogram.cpp"
+#undef max
+
+#include "../../Exercise/06_Binary/Shared/Thresholding.cpp"
@@ -0,0 +1,747 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Benchmark Code
+* \author Suman Kafle
+*
+* Correctness oracle: Runs hand-written ip:: kernels against their OpenCV counterparts on
+* random images, including odd and thin image sizes, all border modes, and kernels larger
+* than the image. Every check is repeated for all SIMD levels of the CPU and for one and
+* several threads, so SIMD, threaded or fixed-point rewrites are verified automatically.
+* The program returns 0 if all checks pass and 1 otherwise.
+*
+* Kernels, OpenCV counterparts and tolerances (maximum absolute difference):
+* - boxFilter             cv::blur on a padded copy      1 (ip truncates the mean, OpenCV rounds)
+* - minMaxFilter          cv::erode/dilate on padded copy 0
+* - sobelFilter           cv::Sobel                       0 (L1, L2 magnitude and edge image)
+*                                                         1 (direction in 1/256 turn, atan by lookup)
+* - findEdgePixels        cv::findNonZero                 0 (also the edge list of sobelFilter())
+* - houghTransform        image-based transform in double 1 (votes at the peaks, lines with r < 0 and r > 0)
+* - templateMatching      cv::matchTemplate(TM_SQDIFF)    1 (8-bit scaled SSD, OpenCV sums in float)
+*                         best match                      SSD at best match equals the minimum SSD
+* - labelRegions          cv::connectedComponents (N4)   0 (labels compared up to renumbering)
+* - bernsenThreshold      cv::erode/dilate (disk)         0 (also the integral image variant)
+* - clamp                 std::min/max per value          0 (8U, 16S, 32S, 32F and 64F, NaN stays NaN)
+* - histogramEqualization cv::equalizeHist               1 + 255 h(g0) / N
+*   (ip maps the lowest occurring gray value g0 to 255 h(g0) / N, OpenCV maps it to 0.
+*   The difference of both mappings decreases linearly to 0 at gray value 255.)
+*
+* Build (Linux, from this folder):
+*   g++ -std=c++17 -O2 -I.. -I../../Exercise/Shared -I../../Exercise/06_Binary/Shared -I../../Exercise/07_Features/Shared \
+*       -I../../Exercise/03_PointOps/HistoEqualization -I"../../Labore/P2 Hough transform" \
+*       Verify.cpp ThresholdingKernel.cpp ../Kernels/{BoxFilter,MinMax,BinaryRegions}Kernel.cpp ../../Exercise/Shared/[A-Z]*.cpp \
+*       "../../Labore/P2 Hough transform/"{Sobel,HoughLine}.cpp \
+*       ../../Exercise/07_Features/Shared/TemplateMatching.cpp ../../Exercise/03_PointOps/HistoEqualization/iputils.cpp \
+*       $(pkg-config --cflags --libs opencv4) -lpthread -o verify
+*/
+
+
+/* Compiler settings */
+#define _USE_MATH_DEFINES
+
+/* Include files */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "EdgeList.h"
+#include "ExerciseKernels.h"
+#include "HoughLine.h"
+#include "IntegralImage.h"
+#include "iputils.h"
+#include "Parallel.h"
+#include "Patterns.h"
+#include "Simd.h"
+#include "Sobel.h"
+#include "TemplateMatching.h"
+#include "Thresholding.h"
+
+/* Defines */
+#define VERIFY_SEED 1					// Seed of the random images
+#define VERIFY_THREADS 4				// Thread count of the multi-threaded runs
+#define BOX_FILTER_TOLERANCE 1			// ip truncates the mean, OpenCV rounds
+#define MIN_MAX_TOLERANCE 0
+#define SOBEL_TOLERANCE 0
+#define SOBEL_DIRECTION_TOLERANCE 1		// atan by lookup
+#define HOUGH_TOLERANCE 1				// Single votes at row boundaries (fixed point radius)
+#define TEMPLATE_TOLERANCE 1			// OpenCV calculates the SSD in float
+#define LABEL_TOLERANCE 0
+#define BERNSEN_TOLERANCE 0
+#define BERNSEN_BACKGROUND 128			// Background differing from both binary values
+#define CLAMP_TOLERANCE 0
+
+/* Namespaces */
+using namespace std;
+
+/* Datatypes */
+/*! Result of all cases of one check. */
+struct Check {
+	string name;
+	int cases = 0;
+	int failures = 0;
+	double maxError = 0.0;
+	double tolerance = 0.0;
+};
+
+/* Prototypes */
+void verifyBoxFilter(const cv::Mat& image);
+void verifyMinMaxFilter(const cv::Mat& image);
+void verifySobelFilter(const cv::Mat& image);
+int compareEdgeList(const ip::EdgeList& edges, const cv::Mat& edgeImage, const cv::Mat& direction, string& details);
+void verifyHoughTransform(cv::Size size);
+void houghReference(const cv::Mat& edgeImage, cv::Mat& houghSpace, int height, int width);
+void verifyTemplateMatching(const cv::Mat& image, uint64_t seed);
+void verifyLabelRegions(cv::Size size, uint64_t seed);
+void verifyHistogramEqualization(const cv::Mat& image);
+void verifyBernsenThreshold(const cv::Mat& image);
+void verifyClamp(const cv::Mat& image);
+void report(const string& name, double error, double tolerance, const string& details = "");
+double maxDifference(const cv::Mat& result, const cv::Mat& expected, string& details);
+void padImage(const cv::Mat& image, cv::Mat& padded, int padX, int padY, ip::BorderMode border);
+
+/* Global variables */
+vector<Check> checks;
+string currentCase;					// Image size, threads and SIMD level of the current run
+
+/* Main function */
+int main()
+{
+	// Odd, thin, tiny and band-splitting image sizes
+	const cv::Size sizes[] = { { 1, 1 }, { 5, 3 }, { 37, 23 }, { 64, 64 }, { 129, 97 }, { 301, 7 }, { 7, 301 }, { 640, 480 } };
+	const int threadCounts[] = { 1, VERIFY_THREADS };
+	const char* simdNames[] = { "none", "SSE2", "AVX2" };
+	ip::SimdLevel maxSimdLevel = ip::detectSimdLevel();
+
+	for (int level = ip::SIMD_NONE; level <= maxSimdLevel; level++) {
+		ip::setSimdLevel((ip::SimdLevel)level);
+
+		for (int threads : threadCounts) {
+			ip::setNumThreads(threads);
+
+			for (const cv::Size& size : sizes) {
+				uint64_t seed = VERIFY_SEED + size.width * 1000 + size.height;
+				cv::Mat image;
+
+				currentCase = to_string(size.width) + "x" + to_string(size.height) + " threads:" + to_string(threads) + " simd:" + simdNames[level];
+				ip::patterns::uniformNoise(image, size, CV_8U, seed);
+
+				verifyBoxFilter(image);
+				verifyMinMaxFilter(image);
+				verifySobelFilter(image);
+				verifyHoughTransform(size);
+				verifyTemplateMatching(image, seed);
+				verifyLabelRegions(size, seed);
+				verifyHistogramEqualization(image);
+				verifyBernsenThreshold(image);
+				verifyClamp(image);
+
+				// Low contrast and smooth image (few, correlated gray values)
+				cv::Mat smooth;
+				ip::patterns::sinusoid(smooth, size, CV_8U, 11.0, 30.0);
+				smooth.convertTo(smooth, CV_8U, 0.25, 96.0);
+				ip::patterns::addGaussianNoise(smooth, 2.0, seed);
+				verifyBoxFilter(smooth);
+				verifyMinMaxFilter(smooth);
+				verifySobelFilter(smooth);
+				verifyHistogramEqualization(smooth);
+				verifyBernsenThreshold(smooth);
+			}
+		}
+	}
+	ip::setSimdLevel(maxSimdLevel);
+
+	// Print summary
+	int failures = 0;
+
+	cout << left << setw(40) << "Check" << setw(8) << "Cases" << setw(10) << "Failed" << setw(12) << "Max error" << "Tolerance" << endl;
+	for (const Check& check : checks) {
+		cout << left << setw(40) << check.name << setw(8) << check.cases << setw(10) << check.failures
+			<< setw(12) << check.maxError << check.tolerance << endl;
+		failures += check.failures;
+	}
+	cout << (failures ? "[FAILED] " : "[PASSED] ") << failures << " failed cases" << endl;
+	return failures ? 1 : 0;
+}
+
+/*! Compare boxFilter() for all border modes and the integral image variant to cv::blur().
+*
+* cv::blur() is applied to a copy padded by the border mode, so OpenCV's border handling
+* does not matter and also borders wider than the image are checked.
+*
+* \param image 8-bit image
+*/
+void verifyBoxFilter(const cv::Mat& image)
+{
+	const int kernelSizes[] = { 1, 3, 7, 31 };
+	const char* borderNames[] = { "zero", "wrap", "reflect", "clamp" };
+
+	for (int kernelSize : kernelSizes) {
+		int k = kernelSize / 2;
+
+		for (int border = ip::BORDER_ZERO; border <= ip::BORDER_CLAMP; border++) {
+			cv::Mat padded, expected, filtered;
+			string details;
+
+			padImage(image, padded, k, k, (ip::BorderMode)border);
+			cv::blur(padded, expected, cv::Size(kernelSize, kernelSize));
+			expected = expected(cv::Rect(k, k, image.cols, image.rows));
+
+			boxFilter(image, filtered, kernelSize, (ip::BorderMode)border);
+			double error = maxDifference(filtered, expected, details);
+			report(string("boxFilter/") + borderNames[border], error, BOX_FILTER_TOLERANCE, "kernel " + to_string(kernelSize) + " " + details);
+
+			// Integral image variant (clamp only)
+			if (border == ip::BORDER_CLAMP) {
+				ip::IntegralImage integral(image);
+
+				boxFilter(image, integral, filtered, kernelSize);
+				error = maxDifference(filtered, expected, details);
+				report("boxFilter/integral", error, BOX_FILTER_TOLERANCE, "kernel " + to_string(kernelSize) + " " + details);
+			}
+		}
+	}
+}
+
+/*! Compare both bernsenThreshold() variants to a threshold from cv::erode() and cv::dilate().
+*
+* The left half of the image is set to a constant (0, 100 or 255 in turn), so the constant
+* neighborhood shortcut of the integral image variant is taken. The background is neither
+* 0 nor 255, so pixels left at background are distinguished from thresholded ones.
+*
+* \param image 8-bit image
+*/
+void verifyBernsenThreshold(const cv::Mat& image)
+{
+	const int radii[] = { 1, 3, 7 };
+	const uchar minContrasts[] = { 0, 15 };
+	const uchar flatValues[] = { 0, 100, 255 };
+
+	for (uchar flatValue : flatValues) {
+		cv::Mat flat = image.clone();
+		flat(cv::Rect(0, 0, (image.cols + 1) / 2, image.rows)) = flatValue;
+		ip::IntegralImage integral(flat);
+
+		for (int radius : radii) {
+			// Extrema of the disk-sized neighborhood
+			int kernelSize = 2 * radius + 1;
+			cv::Mat disk = cv::Mat::zeros(kernelSize, kernelSize, CV_8U), minImage, maxImage;
+
+			for (int dy = -radius; dy <= radius; dy++) {
+				for (int dx = -radius; dx <= radius; dx++)
+					disk.at<uchar>(dy + radius, dx + radius) = (sqrt(dx * dx + dy * dy) <= radius);
+			}
+			cv::erode(flat, minImage, disk);
+			cv::dilate(flat, maxImage, disk);
+
+			for (uchar minContrast : minContrasts) {
+				cv::Mat expected(flat.size(), CV_8U, cv::Scalar(BERNSEN_BACKGROUND)), binImage;
+				string details;
+
+				// Threshold pixels with the full neighborhood inside the image
+				for (int y = radius; y < flat.rows - radius; y++) {
+					for (int x = radius; x < flat.cols - radius; x++) {
+						int min = minImage.at<uchar>(y, x), max = maxImage.at<uchar>(y, x);
+
+						if (max - min >= minContrast)
+							expected.at<uchar>(y, x) = (flat.at<uchar>(y, x) > (min + max) / 2) * 255;
+					}
+				}
+				string parameters = "flat " + to_string(flatValue) + " radius " + to_string(radius) + " contrast " + to_string(minContrast) + " ";
+
+				ip::bernsenThreshold(flat, binImage, radius, minContrast, BERNSEN_BACKGROUND);
+				report("bernsenThreshold", maxDifference(binImage, expected, details), BERNSEN_TOLERANCE, parameters + details);
+
+				ip::bernsenThreshold(flat, integral, binImage, radius, minContrast, BERNSEN_BACKGROUND);
+				report("bernsenThreshold/integral", maxDifference(binImage, expected, details), BERNSEN_TOLERANCE, parameters + details);
+			}
+		}
+	}
+}
+
+/*! Compare clamp() to clamping every value by std::min() and std::max().
+*
+* The values are scaled beyond both bounds. Every 7th float and double value is NaN, which
+* std::min(std::max(NaN, min), max) keeps, so clamp() must keep it as well.
+*
+* \param image 8-bit image
+*/
+void verifyClamp(const cv::Mat& image)
+{
+	const int depths[] = { CV_8U, CV_16S, CV_32S, CV_32F, CV_64F };
+	const char* depthNames[] = { "8U", "16S", "32S", "32F", "64F" };
+	const double low = 40.0, high = 200.0;
+
+	for (int i = 0; i < 5; i++) {
+		cv::Mat values, clamped, expected;
+		image.convertTo(values, depths[i], 2.0, -100.0);
+
+		for (int y = 0; y < values.rows; y++) {
+			for (int x = 0; x < values.cols; x++) {
+				if ((y * values.cols + x) % 7)
+					continue;
+				if (depths[i] == CV_32F)
+					values.at<float>(y, x) = NAN;
+				else if (depths[i] == CV_64F)
+					values.at<double>(y, x) = NAN;
+			}
+		}
+		values.convertTo(expected, CV_64F);
+		ip::clamp(values, low, high);
+		values.convertTo(clamped, CV_64F);
+
+		// Mismatching values (NaN matches NaN only)
+		int mismatches = 0;
+		string details;
+
+		for (int y = 0; y < expected.rows; y++) {
+			for (int x = 0; x < expected.cols; x++) {
+				double value = std::min(std::max(expected.at<double>(y, x), low), high), result = clamped.at<double>(y, x);
+
+				if ((result != value) && !(std::isnan(result) && std::isnan(value)) && !mismatches++)
+					details = "first at (" + to_string(x) + ", " + to_string(y) + ")";
+			}
+		}
+		report(string("clamp/") + depthNames[i], mismatches, CLAMP_TOLERANCE, details);
+	}
+}
+
+/*! Compare minMaxFilter() for all border modes to cv::erode() and cv::dilate().
+*
+* \param image 8-bit image
+*/
+void verifyMinMaxFilter(const cv::Mat& image)
+{
+	const cv::Size kernelSizes[] = { { 1, 1 }, { 3, 3 }, { 5, 9 }, { 15, 15 }, { 31, 3 } };
+	const char* borderNames[] = { "zero", "wrap", "reflect", "clamp" };
+
+	for (const cv::Size& kernelSize : kernelSizes) {
+		cv::Mat kernel = cv::Mat::ones(kernelSize, CV_8U);
+		int kx = kernelSize.width / 2, ky = kernelSize.height / 2;
+		string kernelName = "kernel " + to_string(kernelSize.width) + "x" + to_string(kernelSize.height) + " ";
+
+		for (int border = ip::BORDER_ZERO; border <= ip::BORDER_CLAMP; border++) {
+			cv::Mat padded, expectedMin, expectedMax, minImage, maxImage;
+			cv::Rect inner(kx, ky, image.cols, image.rows);
+			string details;
+
+			padImage(image, padded, kx, ky, (ip::BorderMode)border);
+			cv::erode(padded, expectedMin, kernel);
+			cv::dilate(padded, expectedMax, kernel);
+
+			minMaxFilter(image, minImage, maxImage, kernelSize, (ip::BorderMode)border);
+			double error = maxDifference(minImage, expectedMin(inner), details);
+			report(string("minMaxFilter/min/") + borderNames[border], error, MIN_MAX_TOLERANCE, kernelName + details);
+			error = maxDifference(maxImage, expectedMax(inner), details);
+			report(string("minMaxFilter/max/") + borderNames[border], error, MIN_MAX_TOLERANCE, kernelName + details);
+		}
+	}
+}
+
+/*! Compare sobelFilter() to cv::Sobel().
+*
+* Magnitudes are (|gx| + |gy|) / 8 and sqrt(gx^2 + gy^2) / 8 (truncated) of the OpenCV gradients,
+* the edge image is the L2 magnitude thresholded by 25. Directions are compared cyclically.
+*
+* \param image 8-bit image
+*/
+void verifySobelFilter(const cv::Mat& image)
+{
+	const uchar threshold = 25;
+	cv::Mat gradX, gradY, expectedL1(image.size(), CV_8U), expectedL2(image.size(), CV_8U), expectedEdges(image.size(), CV_8U);
+	cv::Mat expectedDirection(image.size(), CV_8U);
+
+	cv::Sobel(image, gradX, CV_16S, 1, 0, 3);
+	cv::Sobel(image, gradY, CV_16S, 0, 1, 3);
+
+	for (int y = 0; y < image.rows; y++) {
+		for (int x = 0; x < image.cols; x++) {
+			int gx = gradX.at<short>(y, x), gy = gradY.at<short>(y, x);
+			double angle = atan2((double)gy, (double)gx) / (2.0 * M_PI) * 256.0;
+
+			expectedL1.at<uchar>(y, x) = (uchar)((abs(gx) + abs(gy)) / 8);
+			expectedL2.at<uchar>(y, x) = (uchar)(sqrt((double)(gx * gx + gy * gy)) / 8.0);
+			expectedEdges.at<uchar>(y, x) = (expectedL2.at<uchar>(y, x) > threshold) ? 255 : 0;
+			expectedDirection.at<uchar>(y, x) = (uchar)((int)floor(angle + 0.5) & 255);
+		}
+	}
+
+	cv::Mat sobel, direction, edges;
+	string details;
+
+	ip::sobelFilter(image, sobel, ip::SOBEL_L1);
+	report("sobelFilter/L1", maxDifference(sobel, expectedL1, details), SOBEL_TOLERANCE, details);
+
+	ip::sobelFilter(image, sobel, ip::SOBEL_L2, &direction, &edges, threshold);
+	report("sobelFilter/L2", maxDifference(sobel, expectedL2, details), SOBEL_TOLERANCE, details);
+	report("sobelFilter/edges", maxDifference(edges, expectedEdges, details), SOBEL_TOLERANCE, details);
+
+	// Cyclic difference of directions (255 and 0 are neighbors)
+	int maxError = 0;
+
+	details.clear();
+	for (int y = 0; y < image.rows; y++) {
+		for (int x = 0; x < image.cols; x++) {
+			int difference = (direction.at<uchar>(y, x) - expectedDirection.at<uchar>(y, x)) & 255;
+
+			if (min(difference, 256 - difference) > maxError) {
+				maxError = min(difference, 256 - difference);
+				details = "at (" + to_string(x) + ", " + to_string(y) + ")";
+			}
+		}
+	}
+	report("sobelFilter/direction", maxError, SOBEL_DIRECTION_TOLERANCE, details);
+
+	// Edge pixels (with directions) of the edge image
+	ip::EdgeList edgeList;
+
+	ip::sobelFilter(image, sobel, ip::SOBEL_L2, NULL, NULL, threshold, &edgeList);
+	report("sobelFilter/edgeList", compareEdgeList(edgeList, expectedEdges, expectedDirection, details), SOBEL_TOLERANCE, details);
+
+	ip::findEdgePixels(expectedEdges, edgeList, expectedDirection);
+	report("findEdgePixels", compareEdgeList(edgeList, expectedEdges, expectedDirection, details), SOBEL_TOLERANCE, details);
+}
+
+/*! Compare an edge list to the nonzero pixels of an edge image (cv::findNonZero()).
+*
+* \param edges Edge list to check
+* \param edgeImage Expected edge image
+* \param direction Expected directions (compared with tolerance SOBEL_DIRECTION_TOLERANCE)
+* \param details [out] First mismatching entry
+* \return number of mismatching entries
+*/
+int compareEdgeList(const ip::EdgeList& edges, const cv::Mat& edgeImage, const cv::Mat& direction, string& details)
+{
+	vector<cv::Point> points;
+	int mismatches = 0;
+
+	cv::findNonZero(edgeImage, points);
+	details = to_string(points.size()) + " edge pixels";
+	if ((edges.size() != points.size()) || (edges.direction.size() != points.size()) || (edges.imageSize != edgeImage.size())) {
+		details += ", list has " + to_string(edges.size());
+		return (int)max(edges.size(), points.size()) + 1;
+	}
+
+	for (size_t i = 0; i < points.size(); i++) {
+		int difference = (edges.direction[i] - direction.at<uchar>(points[i].y, points[i].x)) & 255;
+		bool isMatch = (edges.x[i] == points[i].x) && (edges.y[i] == points[i].y) && (min(difference, 256 - difference) <= SOBEL_DIRECTION_TOLERANCE);
+
+		if (!isMatch && !mismatches++)
+			details += ", first at index " + to_string(i);
+	}
+	return mismatches;
+}
+
+/*! Compare houghTransform() of an edge list and its peaks to the image-based transform in double.
+*
+* The edge image holds lines with negative and positive radius r. The reference is the
+* floating point transform the fixed point one replaced: Row v0 + (int)(r / deltaRadius + 0.5),
+* i. e., the rounded radius truncated towards zero. Single votes may move by one row where the
+* fixed point radius is close to a row boundary, which can swap nearly equal peaks. So both
+* accumulators are compared at the peaks of either one: A radius binned differently moves all
+* votes of the line off the peak.
+*
+* \param size Edge image size
+*/
+void verifyHoughTransform(cv::Size size)
+{
+	const cv::Size houghSizes[] = { { 720, 721 }, { 180, 400 } };
+	const double lines[][2] = { { 30.0, -0.3 }, { 110.0, -0.2 }, { 160.0, 0.25 } };	// theta in degrees, r relative to image height
+	const int numLines = sizeof(lines) / sizeof(lines[0]);
+	cv::Mat edgeImage = cv::Mat::zeros(size, CV_8U);
+
+	// Edge pixels within half a pixel of the lines
+	for (const double* line : lines) {
+		double cosTheta = cos(line[0] * M_PI / 180.0), sinTheta = sin(line[0] * M_PI / 180.0), r = line[1] * size.height;
+
+		for (int y = 0; y < size.height; y++) {
+			for (int x = 0; x < size.width; x++) {
+				if (fabs((x - size.width / 2) * cosTheta + (y - size.height / 2) * sinTheta - r) < 0.5)
+					edgeImage.at<uchar>(y, x) = 255;
+			}
+		}
+	}
+
+	ip::EdgeList edges;
+	ip::findEdgePixels(edgeImage, edges);
+
+	for (const cv::Size& houghSize : houghSizes) {
+		cv::Mat houghSpace, expected;
+		vector<ip::houghPeak> peaks, expectedPeaks;
+		string details = "hough " + to_string(houghSize.width) + "x" + to_string(houghSize.height);
+
+		ip::houghTransform(edges, houghSpace, houghSize.height, houghSize.width);
+		houghReference(edgeImage, expected, houghSize.height, houghSize.width);
+		ip::houghPeaks(houghSpace, size, peaks, numLines);
+		ip::houghPeaks(expected, size, expectedPeaks, numLines);
+
+		// Difference of votes at the peaks of both transforms
+		double maxError = (peaks.size() == expectedPeaks.size()) ? 0.0 : HUGE_VAL;
+		cv::Point maxLocation;
+
+		peaks.insert(peaks.end(), expectedPeaks.begin(), expectedPeaks.end());
+		for (const ip::houghPeak& peak : peaks) {
+			int error = abs(houghSpace.at<int>(peak.location) - expected.at<int>(peak.location));
+
+			if (error > maxError) {
+				maxError = error;
+				maxLocation = peak.location;
+			}
+		}
+		details += " at (" + to_string(maxLocation.x) + ", " + to_string(maxLocation.y) + ")";
+		report("houghTransform/edgeList", maxError, HOUGH_TOLERANCE, details);
+	}
+}
+
+/*! Calculate the Hough transform for lines by voting in double for each edge pixel.
+*
+* \param edgeImage Edge image (edge pixels nonzero)
+* \param houghSpace [out] Raw counts (CV_32S), radii beyond the last row count for the last row
+* \param height Height of the Hough space (r axis)
+* \param width Width of the Hough space (theta axis, covering [0, pi])
+*/
+void houghReference(const cv::Mat& edgeImage, cv::Mat& houghSpace, int height, int width)
+{
+	double deltaTheta = M_PI / (double)width;
+	double deltaRadius = sqrt(edgeImage.cols * edgeImage.cols + edgeImage.rows * edgeImage.rows) / height;
+	int v0 = height / 2;
+
+	houghSpace = cv::Mat::zeros(height, width, CV_32S);
+	for (int y = 0; y < edgeImage.rows; y++) {
+		for (int x = 0; x < edgeImage.cols; x++) {
+			if (!edgeImage.at<uchar>(y, x))
+				continue;
+
+			for (int u = 0; u < width; u++) {
+				double r = (x - edgeImage.cols / 2) * cos(deltaTheta * u) + (y - edgeImage.rows / 2) * sin(deltaTheta * u);
+				int v = v0 + (int)(r / deltaRadius + 0.5);
+
+				houghSpace.at<int>(min(v, height - 1), u)++;
+			}
+		}
+	}
+}
+
+/*! Compare templateMatching() with and without integral image to cv::matchTemplate(TM_SQDIFF).
+*
+* The templates are cut from the image at random locations. The SSD image of ip:: is scaled
+* to 8 bit by 255 / max(SSD), the OpenCV result is scaled the same way. The best match may
+* differ for equal SSDs, so the OpenCV SSD at the ip:: best match must be the minimum SSD.
+*
+* \param image Random 8-bit image
+* \param seed Seed of the template locations
+*/
+void verifyTemplateMatching(const cv::Mat& image, uint64_t seed)
+{
+	const cv::Size objectSizes[] = { { 1, 1 }, { 3, 5 }, { 15, 15 } };
+	mt19937 random((uint32_t)seed);
+	ip::IntegralImage integral(image);
+
+	for (const cv::Size& objectSize : objectSizes) {
+		// At least two locations needed (a single SSD cannot be scaled by its maximum)
+		if ((objectSize.width >= image.cols) || (objectSize.height >= image.rows))
+			continue;
+
+		int x = random() % (image.cols - objectSize.width + 1);
+		int y = random() % (image.rows - objectSize.height + 1);
+		cv::Mat object = image(cv::Rect(x, y, objectSize.width, objectSize.height)).clone();
+		string objectName = "template " + to_string(objectSize.width) + "x" + to_string(objectSize.height) + " ";
+
+		cv::Mat ssd, expected;
+		double minSSD, maxSSD;
+		cv::matchTemplate(image, object, ssd, cv::TM_SQDIFF);
+		cv::minMaxLoc(ssd, &minSSD, &maxSSD);
+		ssd.convertTo(expected, CV_8U, 255.0 / maxSSD);
+
+		for (int variant = 0; variant < 2; variant++) {
+			string name = variant ? "templateMatching/integral" : "templateMatching";
+			cv::Mat ssdImage;
+			cv::Point bestMatch;
+			string details;
+
+			if (variant)
+				ip::templateMatching(image, integral, object, ssdImage, bestMatch);
+			else
+				ip::templateMatching(image, object, ssdImage, bestMatch);
+
+			double error = maxDifference(ssdImage, expected, details);
+			report(name, error, TEMPLATE_TOLERANCE, objectName + details);
+
+			// SSD at best match relative to the float accuracy of OpenCV
+			bool isInside = (bestMatch.x >= 0) && (bestMatch.x < ssd.cols) && (bestMatch.y >= 0) && (bestMatch.y < ssd.rows);
+			error = isInside ? (ssd.at<float>(bestMatch) - minSSD) / (1e-5 * maxSSD + 1.0) : HUGE_VAL;
+			report(name + "/bestMatch", max(error, 0.0), 1.0, objectName + "at (" + to_string(bestMatch.x) + ", " + to_string(bestMatch.y) + ")");
+		}
+	}
+}
+
+/*! Compare labelRegions() (N4 flood fill) to cv::connectedComponents().
+*
+* The binary image consists of random rectangles (overlapping, touching the border) and a
+* patch of diagonal neighbors (separate regions in N4). Labels are compared up to
+* renumbering: Each ip:: label must correspond to exactly one OpenCV label and vice versa.
+* The number of regions is kept below the 253 labels of ip::labelRegions().
+*
+* \param size Image size
+* \param seed Seed of the rectangles
+*/
+void verifyLabelRegions(cv::Size size, uint64_t seed)
+{
+	mt19937 random((uint32_t)seed);
+	cv::Mat binImage = cv::Mat::zeros(size, CV_8U);
+
+	// Random rectangles
+	int numRects = min(150, size.area() / 16 + 1);
+
+	for (int i = 0; i < numRects; i++) {
+		int x = random() % size.width, y = random() % size.height;
+		int width = 1 + random() % max(size.width / 8, 1), height = 1 + random() % max(size.height / 8, 1);
+
+		binImage(cv::Rect(x, y, min(width, size.width - x), min(height, size.height - y))) = 1;
+	}
+
+	// Diagonal neighbors (checkerboard of single pixels)
+	cv::Rect patch(0, 0, min(size.width, 8), min(size.height, 8));
+	cv::Mat checkerboard;
+	ip::patterns::checkerboard(checkerboard, patch.size(), CV_8U, 1);
+	checkerboard /= 255;
+	checkerboard.copyTo(binImage(patch));
+
+	cv::Mat expected, labeled = binImage.clone();
+	int numLabels = cv::connectedComponents(binImage, expected, 4, CV_32S);
+	ip::labelRegions(labeled);
+
+	// Compare labels up to renumbering
+	vector<int> ipToCv(256, -1), cvToIp(numLabels, -1);
+	int mismatches = 0;
+	string details;
+
+	for (int y = 0; y < size.height; y++) {
+		const uchar* labeledRow = labeled.ptr<uchar>(y);
+		const int* expectedRow = expected.ptr<int>(y);
+
+		for (int x = 0; x < size.width; x++) {
+			int label = labeledRow[x], cvLabel = expectedRow[x];
+			bool isMatch = ((label == 0) == (cvLabel == 0)) && (label != 1);
+
+			if (isMatch && label) {
+				if (ipToCv[label] < 0)
+					ipToCv[label] = cvLabel;
+				if (cvToIp[cvLabel] < 0)
+					cvToIp[cvLabel] = label;
+				isMatch = (ipToCv[label] == cvLabel) && (cvToIp[cvLabel] == label);
+			}
+
+			if (!isMatch && !mismatches++)
+				details = "first at (" + to_string(x) + ", " + to_string(y) + ")";
+		}
+	}
+	report("labelRegions", mismatches, LABEL_TOLERANCE, to_string(numLabels - 1) + " regions " + details);
+}
+
+/*! Compare histogramEqualization() to cv::equalizeHist().
+*
+* \param image 8-bit image
+*/
+void verifyHistogramEqualization(const cv::Mat& image)
+{
+	cv::Mat equalized, expected;
+	string details;
+
+	ip::histogramEqualization(image, equalized);
+	cv::equalizeHist(image, expected);
+
+	// Number of pixels of the lowest gray value (see header)
+	double minValue;
+	cv::minMaxLoc(image, &minValue);
+	int lowestCount = 0;
+
+	for (int y = 0; y < image.rows; y++) {
+		const uchar* row = image.ptr<uchar>(y);
+
+		for (int x = 0; x < image.cols; x++)
+			lowestCount += (row[x] == minValue);
+	}
+
+	double tolerance = 1.0 + floor(255.0 * lowestCount / image.total());
+	double error = maxDifference(equalized, expected, details);
+	report("histogramEqualization", error, tolerance, details);
+}
+
+/*! Record the result of one case of a check and print failures.
+*
+* \param name Name of the check
+* \param error Maximum error of this case
+* \param tolerance Maximum allowed error
+* \param details Parameters and location of the error
+*/
+void report(const string& name, double error, double tolerance, const string& details)
+{
+	auto check = find_if(checks.begin(), checks.end(), [&](const Check& c) { return c.name == name; });
+
+	if (check == checks.end()) {
+		checks.push_back(Check());
+		check = checks.end() - 1;
+		check->name = name;
+	}
+
+	check->cases++;
+	check->maxError = max(check->maxError, error);
+	check->tolerance = max(check->tolerance, tolerance);
+	if (!(error <= tolerance)) {
+		check->failures++;
+		cout << "[FAILED] " << name << " " << currentCase << " " << details << ": error " << error << " > " << tolerance << endl;
+	}
+}
+
+/*! Maximum absolute difference of two 8-bit images.
+*
+* \param result Image to check
+* \param expected Expected image
+* \param details [out] Location of the maximum difference
+* \return maximum absolute difference (infinite for different sizes or types)
+*/
+double maxDifference(const cv::Mat& result, const cv::Mat& expected, string& details)
+{
+	int maxError = 0;
+
+	details.clear();
+	if ((result.size() != expected.size()) || (result.type() != CV_8U) || (expected.type() != CV_8U)) {
+		details = "size or type differs";
+		return HUGE_VAL;
+	}
+
+	for (int y = 0; y < result.rows; y++) {
+		const uchar* resultRow = result.ptr<uchar>(y);
+		const uchar* expectedRow = expected.ptr<uchar>(y);
+
+		for (int x = 0; x < result.cols; x++) {
+			int error = abs((int)resultRow[x] - (int)expectedRow[x]);
+
+			if (error > maxError) {
+				maxError = error;
+				details = "at (" + to_string(x) + ", " + to_string(y) + ")";
+			}
+		}
+	}
+	return maxError;
+}
+
+/*! Pad an image by the ip:: border mode.
+*
+* \param image Source image
+* \param padded [out] Image with padX columns and padY rows added on each side
+* \param padX Number of columns to add left and right
+* \param padY Number of rows to add at the top and bottom
+* \param border Border extension mode
+*/
+void padImage(const cv::Mat& image, cv::Mat& padded, int padX, int padY, ip::BorderMode border)
+{
+	const int cvBorders[] = { cv::BORDER_CONSTANT, cv::BORDER_WRAP, cv::BORDER_REFLECT, cv::BORDER_REPLICATE };
+
+	cv::copyMakeBorder(image, padded, padY, padY, padX, padX, cvBorders[border], cv::Scalar(0));
+}
@@ -19,6 +19,9 @@
 #define IMAGE_DATA_PATH getenv("ImagingData")			// Read environment variable ImagingData
 #define INPUT_IMAGE_RELATIVE_PATH "/Images/Ton12.jpg"	// Image file including relative path
 #define USE_OPENCV_METHOD 0								// Use OpenCV method or own implementation
+#define USE_ADAPTIVE_METHOD 0							// Use contrast-limited adaptive histogram equalization (CLAHE)
+#define CLAHE_CLIP_LIMIT 2.0							// Bin limit relative to the average bin count of a tile
+#define CLAHE_TILE_GRID cv::Size(8, 8)					// Number of tiles in x and y
 #define WRITE_IMAGE_FILES 0
 
 /* Namespaces */
@@ -38,8 +41,12 @@ int main()
 
 	// Apply histogram equalization
 	cv::Mat processed;
-#if USE_OPENCV_METHOD == 1
+#if (USE_OPENCV_METHOD == 1) && (USE_ADAPTIVE_METHOD == 1)
+	cv::createCLAHE(CLAHE_CLIP_LIMIT, CLAHE_TILE_GRID)->apply(image, processed);
+#elif USE_OPENCV_METHOD == 1
 	cv::equalizeHist(image, processed);
+#elif USE_ADAPTIVE_METHOD == 1
+	ip::adaptiveHistogramEqualization(image, processed, CLAHE_CLIP_LIMIT, CLAHE_TILE_GRID);
 #else
 	ip::histogramEqualization(image, processed);
 #endif
@@ -8,7 +8,11 @@
 
 /* Include files */
 #include "iputils.h"
+#include "HistogramKernel.h"
+#include "Parallel.h"
+#include <cmath>
 #include <iostream>
+#include <vector>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
@@ -17,51 +21,6 @@ using namespace std;
 
 namespace ip
 {
-	/*! Keep ("clamp") a value inside a specific range [min, max].
-	*
-	* Sets values < min to min and values > max to max.
-	*
-	* \param value Value to clamp
-	* \param min Lower bound of the range
-	* \param max Upper bound of the range
-	* \return value clamped to [min, max]
-	*/
-	inline uchar clamp(int value, uchar min, uchar max)
-	{
-		if ((value >= min) && (value <= max))
-			return value;
-		else
-			return (value < min) ? min : max;
-	}
-
-	/*! Clamp pixel values to be within [min, max].
-	*
-	* All values < min will be set to min.
-	* All values > max will be set to max.
-	*
-	* \param image Image with pixels to clamp
-	* \param min Minimum value
-	* \param max Maximum value
-	*/
-	void clamp(cv::Mat& image, uchar min, uchar max)
-	{
-		// 8-bit grayscale
-		if (image.type() == CV_8U) {
-			for (int y = 0; y < image.rows; y++) {
-				uchar* data = image.ptr<uchar>(y);
-
-				for (int x = 0; x < image.cols; x++) {
-					if (data[x] < min)
-						data[x] = min;
-					else if (data[x] > max)
-						data[x] = max;
-				}
-			}
-		}
-		else
-			cout << "[WARNING] Pixel type not supported in clamp()" << endl;
-	}
-
 	/*! Determine the maximum value inside an array.
 	*
 	* \param values Array to search for maximum value
@@ -80,52 +39,68 @@ namespace ip
 
 	/*! Calculate the histogram data for 8-bit grayscale images.
 	*
-	* \param image Image to calculate histogram for (8-bit grayscale)
+	* Rows are counted in parallel into interleaved sub-histograms (see countHistogram()).
+	* Color images are counted by their luma, 16-bit images by the 8 most significant bits.
+	*
+	* \param image Image to calculate histogram for (8-bit grayscale, or BGR and/or 16 bit)
 	* \param histogram Array to store histogram data in
+	* \param cumulative Array to store cumulative histogram data in (optional)
+	* \param bits Significant bits of 16-bit images, e. g., 12 for Mono12 (0: 8 or 16 by image depth)
 	*/
-	void calcHistogram(const cv::Mat& image, unsigned histogram[256]) {
-		const int NUMBER_BINS = 256;
-
-		// Check for correct image type (8-bit grayscale)
-		if (image.type() != CV_8U)
+	void calcHistogram(const cv::Mat& image, unsigned histogram[256], unsigned cumulative[256], int bits) {
+		// 8-bit grayscale
+		if (image.type() == CV_8U) {
+			countHistogram(image, histogram, cumulative);
 			return;
+		}
 
-		// Init array
-		for (int i = 0; i < NUMBER_BINS; i++)
-			histogram[i] = 0;
+		// Luma of color images and/or 16-bit images
+		vector<unsigned> hist;
+		calcHistogram(image, hist, HISTOGRAM_LUMA, 256, bits);
 
-		// Count pixel values
-		for (int y = 0; y < image.rows; y++) {
-			const uchar* data = image.ptr<uchar>(y);
-			for (int x = 0; x < image.cols; x++) {
-				histogram[data[x]]++;
-			}
-		}
+		for (int g = 0; g < 256; g++)
+			histogram[g] = hist[g];
+		if (cumulative != NULL)
+			cumulateHistogram(histogram, cumulative);
+	}
+
+	/*! Calculate the histogram of one channel (or the luma) of an 8-bit or 16-bit image.
+	*
+	* 16-bit images may use up to 65536 bins (one bin per value, see sparseHistogram() to list
+	* the occupied bins only) or fewer, wider bins.
+	*
+	* \param image Image to calculate histogram for (depth CV_8U or CV_16U, one or three channels)
+	* \param histogram Vector to store histogram data in (resized to bins)
+	* \param channel Channel index or HISTOGRAM_LUMA (luma of BGR images)
+	* \param bins Number of bins (power of 2)
+	* \param bits Significant bits, e. g., 10 for Mono10 (0: 8 or 16 by image depth)
+	*/
+	void calcHistogram(const cv::Mat& image, vector<unsigned>& histogram, int channel, int bins, int bits) {
+		countHistogram(image, histogram, channel, bins, bits);
 	}
 
 	/*! Create image depicting the histogram and cumulative histogram of a 8-bit grayscale image.
 	*
+	* Color images are charted by their luma, 16-bit images by the 8 most significant bits.
+	*
 	* \param image Image to create histogram for
 	* \param histogram Resulting histogram chart
 	* \param isCumulative Draw cumulative histogram on chart, if true
+	* \param bits Significant bits of 16-bit images (0: 16)
 	*/
-	void histogramChart(const cv::Mat& image, cv::Mat& histogram, bool isCumulative)
+	void histogramChart(const cv::Mat& image, cv::Mat& histogram, bool isCumulative, int bits)
 	{
 		const int NUMBER_BINS = 256;
 		const int WEDGE_HEIGHT = 10;
 
-		// Check for correct image type (8-bit grayscale)
-		if (image.type() != CV_8U)
+		// Check for correct image depth (8 or 16 bit)
+		if ((image.depth() != CV_8U) && (image.depth() != CV_16U))
 			return;
 
 		// Init array and count pixels
 		unsigned hist[NUMBER_BINS] = { 0 };
 		unsigned cumHist[NUMBER_BINS] = { 0 };
-		calcHistogram(image, hist);
-
-		cumHist[0] = hist[0];
-		for (int i = 1; i < NUMBER_BINS; i++)
-			cumHist[i] = cumHist[i-1] + hist[i];
+		calcHistogram(image, hist, cumHist, bits);
 
 		// Find maximum histogram value
 		unsigned maxCount = max(hist, NUMBER_BINS);
@@ -161,29 +136,262 @@ namespace ip
 		}
 	}
 
-	void histogramEqualization(const cv::Mat& image, cv::Mat& processed) {
-		const int NUMBER_BINS = 256;
+	/*! Equalize color and/or 16-bit images by full-resolution LUTs (one bin per value).
+	*
+	* \param image Source image to equalize (one or three channels)
+	* \param processed Destination image
+	* \param isPerChannel Equalize each channel by its own histogram, if true, or all channels by the luma histogram
+	*/
+	template <typename T>
+	static void equalizeChannels(const cv::Mat& image, cv::Mat& processed, bool isPerChannel) {
+		int bins = 1 << (8 * sizeof(T)), channels = image.channels();
+		int numLuts = isPerChannel ? channels : 1;
+		vector<vector<T>> luts(numLuts, vector<T>(bins));
 
-		// Check for correct image type (8-bit grayscale)
-		if (image.type() != CV_8U)
+		// LUT per channel (or for all channels) from the cumulative histogram
+		for (int c = 0; c < numLuts; c++) {
+			vector<unsigned> hist, cumHist;
+
+			countHistogram(image, hist, isPerChannel ? c : HISTOGRAM_LUMA, bins);
+			cumulateHistogram(hist, cumHist);
+
+			double scale = (bins - 1.0) / ((double)image.rows * image.cols);
+
+			for (int g = 0; g < bins; g++)
+				luts[c][g] = (T)(scale * cumHist[g] + 0.5);
+		}
+
+		// Apply LUTs
+		cv::Mat source = (image.data == processed.data) ? image.clone() : image;
+		processed.create(image.rows, image.cols, image.type());
+
+		parallelRows(image.rows, 0, [&](const RowBand& band) {
+			for (int y = band.rowBegin; y < band.rowEnd; y++) {
+				const T* srcRow = source.ptr<T>(y);
+				T* dstRow = processed.ptr<T>(y);
+
+				for (int x = 0; x < image.cols * channels; x++)
+					dstRow[x] = luts[isPerChannel ? (x % channels) : 0][srcRow[x]];
+			}
+		});
+	}
+
+	/*! Apply histogram equalization to an 8-bit or 16-bit grayscale or BGR image.
+	*
+	* BGR images are equalized either per channel (changes the color balance) or all channels
+	* by the LUT of the luma histogram. 16-bit images use one bin per value (65536 bins).
+	*
+	* \param image Source image to equalize (depth CV_8U or CV_16U, one or three channels)
+	* \param processed Destination image (may be empty when passed to the method)
+	* \param isPerChannel Equalize each channel of BGR images by its own histogram, if true
+	*/
+	void histogramEqualization(const cv::Mat& image, cv::Mat& processed, bool isPerChannel) {
+		// 8-bit grayscale
+		if (image.type() == CV_8U) {
+			// Calculate histogram and apply equalization
+			StreamingHistogram histogram(image);
+			histogramEqualization(image, processed, histogram);
 			return;
+		}
 
-		// Calculate histogram
-		unsigned histogram[NUMBER_BINS] = { 0 };
+		// Check for supported image types (color and/or 16 bit)
+		if ((image.channels() != 1) && (image.channels() != 3)) {
+			cout << "[WARNING] Grayscale or BGR image expected." << endl;
+			return;
+		}
+
+		if (image.depth() == CV_8U)
+			equalizeChannels<uchar>(image, processed, isPerChannel);
+		else if (image.depth() == CV_16U)
+			equalizeChannels<ushort>(image, processed, isPerChannel);
+		else
+			cout << "[WARNING] Incorrect image depth. CV_8U or CV_16U expected." << endl;
+	}
+
+	/*! Calculate the histogram equalization LUT of a histogram.
+	*
+	* \param histogram Histogram (at least one pixel)
+	* \param lut [out] Mapping g -> 255 * H(g) / N with cumulative histogram H and number of pixels N
+	*/
+	static void equalizationLut(const StreamingHistogram& histogram, uchar lut[256]) {
+		const int NUMBER_BINS = 256;
+
+		// Calculate cumulative histogram
 		unsigned cumHist[NUMBER_BINS] = { 0 };
-		calcHistogram(image, histogram);
+		histogram.getCumulative(cumHist);
+
+		// Create LUT
+		double scale = 255.0 / histogram.count();
+
+		for (int g = 0; g < NUMBER_BINS; g++) {
+			lut[g] = (uchar)(scale * cumHist[g] + 0.5);
+		}
+	}
 
-		cumHist[0] = histogram[0];
-		for (int i = 1; i < NUMBER_BINS; i++)
-			cumHist[i] = cumHist[i - 1] + histogram[i];
+	/*! Apply histogram equalization to an 8-bit grayscale image based on a given histogram.
+	*
+	* The histogram may be of another region than the image, e. g., of a sliding window over
+	* the recent frames of a video or of a tile around the image.
+	*
+	* \param image Source image to equalize
+	* \param processed Destination image (may be empty when passed to the method)
+	* \param histogram Histogram to calculate the cumulative histogram (mapping) from
+	*/
+	void histogramEqualization(const cv::Mat& image, cv::Mat& processed, const StreamingHistogram& histogram) {
+		// Check for correct image type (8-bit grayscale) and histogram
+		if ((image.type() != CV_8U) || (histogram.count() == 0))
+			return;
 
 		// Create and apply LUT
-		cv::Mat lut(1, 256, CV_8U);
-		double scale = 255.0 / ((double)image.rows * image.cols);
+		PointOpChain chain;
+		histogramEqualization(histogram, chain);
+		chain.apply(image, processed);
+	}
 
-		for (int g = 0; g < 256; g++) {
-			lut.at<uchar>(g) = (uchar)(scale * cumHist[g] + 0.5);
+	/*! Append histogram equalization based on a histogram to a chain of point operations.
+	*
+	* \param histogram Histogram to calculate the cumulative histogram (mapping) from (at least one pixel)
+	* \param chain Chain of point operations to append the equalization to
+	*/
+	void histogramEqualization(const StreamingHistogram& histogram, PointOpChain& chain) {
+		uchar lut[256];
+
+		equalizationLut(histogram, lut);
+		chain.then(lut);
+	}
+
+	/*! Split an image dimension into tiles and find the two tiles to interpolate between.
+	*
+	* Tile t covers [t * size / numTiles, (t + 1) * size / numTiles). Positions between the
+	* centers of tiles t and t + 1 interpolate between both tiles, positions outside the outer
+	* centers use the outer tile only.
+	*
+	* \param size Image width or height
+	* \param numTiles Number of tiles
+	* \param tile0 [out] First tile per position
+	* \param tile1 [out] Second tile per position
+	* \param weight1 [out] Weight of the second tile per position in [0, 256]
+	*/
+	static void interpolationTiles(int size, int numTiles, vector<int>& tile0, vector<int>& tile1, vector<int>& weight1) {
+		tile0.resize(size);
+		tile1.resize(size);
+		weight1.resize(size);
+
+		for (int i = 0; i < size; i++) {
+			double position = (i + 0.5) * numTiles / size - 0.5;		// In tile units (tile centers at integers)
+			int t = (int)floor(position);
+
+			if (t < 0) {
+				tile0[i] = tile1[i] = 0;
+				weight1[i] = 0;
+			}
+			else if (t >= numTiles - 1) {
+				tile0[i] = tile1[i] = numTiles - 1;
+				weight1[i] = 0;
+			}
+			else {
+				tile0[i] = t;
+				tile1[i] = t + 1;
+				weight1[i] = (int)(256.0 * (position - t) + 0.5);
+			}
 		}
-		cv::LUT(image, lut, processed);
+	}
+
+	/*! Apply contrast-limited adaptive histogram equalization (CLAHE) to an 8-bit grayscale image.
+	*
+	* The image is split into a grid of tiles. Each tile gets its own equalization LUT from its
+	* histogram, after clipping the bins at clipLimit times the average bin count and
+	* redistributing the clipped pixels over all bins (limits the contrast gain in flat regions).
+	* Tile LUTs are calculated in parallel. A single parallel pass over the rows then maps each
+	* pixel by bilinear interpolation between the LUTs of the four nearest tile centers
+	* (fixed point, all LUTs of a tile row in cache).
+	*
+	* Reference: K. Zuiderveld: Contrast Limited Adaptive Histogram Equalization, Graphics Gems IV, 1994.
+	*
+	* \param image Source image to equalize
+	* \param processed Destination image (may be empty when passed to the method)
+	* \param clipLimit Bin limit relative to the average bin count of a tile (<= 0: no limit)
+	* \param tileGrid Number of tiles in x and y
+	*/
+	void adaptiveHistogramEqualization(const cv::Mat& image, cv::Mat& processed, double clipLimit, cv::Size tileGrid) {
+		const int NUMBER_BINS = 256;
+
+		// Check for correct image type (8-bit grayscale) and tile grid
+		if (image.type() != CV_8U)
+			return;
+		if ((tileGrid.width < 1) || (tileGrid.height < 1)) {
+			cout << "[WARNING] Tile grid must have at least one tile in x and y." << endl;
+			return;
+		}
+
+		int tilesX = std::min(tileGrid.width, image.cols), tilesY = std::min(tileGrid.height, image.rows);
+		vector<uchar> luts((size_t)tilesX * tilesY * NUMBER_BINS);
+
+		// Calculate clipped histogram and LUT per tile
+		parallelFor(tilesX * tilesY, [&](int i) {
+			int tx = i % tilesX, ty = i / tilesX;
+			cv::Range rows(ty * image.rows / tilesY, (ty + 1) * image.rows / tilesY);
+			cv::Range cols(tx * image.cols / tilesX, (tx + 1) * image.cols / tilesX);
+			unsigned histogram[NUMBER_BINS];
+
+			countHistogram(image(rows, cols), histogram);
+
+			// Clip bins and redistribute clipped pixels evenly, remainder with equal spacing
+			if (clipLimit > 0.0) {
+				unsigned limit = std::max((unsigned)(clipLimit * rows.size() * cols.size() / NUMBER_BINS), 1u);
+				unsigned excess = 0;
+
+				for (int g = 0; g < NUMBER_BINS; g++) {
+					if (histogram[g] > limit) {
+						excess += histogram[g] - limit;
+						histogram[g] = limit;
+					}
+				}
+
+				unsigned batch = excess / NUMBER_BINS, residual = excess % NUMBER_BINS;
+
+				for (int g = 0; g < NUMBER_BINS; g++)
+					histogram[g] += batch;
+				if (residual > 0) {
+					int step = std::max(NUMBER_BINS / (int)residual, 1);
+
+					for (int g = 0; (g < NUMBER_BINS) && (residual > 0); g += step, residual--)
+						histogram[g]++;
+				}
+			}
+
+			StreamingHistogram tileHistogram;
+			tileHistogram.add(histogram);
+			equalizationLut(tileHistogram, &luts[(size_t)i * NUMBER_BINS]);
+		});
+
+		// Tiles and weights per column and row
+		vector<int> tileX0, tileX1, weightX, tileY0, tileY1, weightY;
+
+		interpolationTiles(image.cols, tilesX, tileX0, tileX1, weightX);
+		interpolationTiles(image.rows, tilesY, tileY0, tileY1, weightY);
+
+		// Map pixels by bilinear interpolation between the LUTs of the four nearest tiles
+		cv::Mat source = (image.data == processed.data) ? image.clone() : image;
+		processed.create(image.rows, image.cols, CV_8U);
+
+		parallelRows(image.rows, 0, [&](const RowBand& band) {
+			for (int y = band.rowBegin; y < band.rowEnd; y++) {
+				const uchar* srcRow = source.ptr<uchar>(y);
+				uchar* dstRow = processed.ptr<uchar>(y);
+				const uchar* lutsTop = &luts[(size_t)tileY0[y] * tilesX * NUMBER_BINS];
+				const uchar* lutsBottom = &luts[(size_t)tileY1[y] * tilesX * NUMBER_BINS];
+				int wy = weightY[y];
+
+				for (int x = 0; x < image.cols; x++) {
+					int g = srcRow[x], wx = weightX[x];
+					int left = tileX0[x] * NUMBER_BINS + g, right = tileX1[x] * NUMBER_BINS + g;
+					int top = lutsTop[left] * (256 - wx) + lutsTop[right] * wx;
+					int bottom = lutsBottom[left] * (256 - wx) + lutsBottom[right] * wx;
+
+					dstRow[x] = (uchar)((top * (256 - wy) + bottom * wy + (1 << 15)) >> 16);
+				}
+			}
+		});
 	}
 }
@@ -11,19 +11,25 @@
 #define IP_UTILS_H
 
 /* Include files */
+#include <vector>
 #include <opencv2/core/core.hpp>
+#include "Clamp.h"
+#include "HistogramKernel.h"
+#include "PointOpChain.h"
+#include "StreamingHistogram.h"
 
 namespace ip
 {
 	/* Prototypes */
-	inline uchar clamp(int value, uchar min, uchar max);
-	void clamp(cv::Mat& image, uchar min, uchar max);
-
 	unsigned max(unsigned values[], int size);
-	void calcHistogram(const cv::Mat& image, unsigned histogram[256]);
-	void histogramChart(const cv::Mat& image, cv::Mat& histogram, bool isCumulative = true);
-
-	void histogramEqualization(const cv::Mat& image, cv::Mat& processed);
+	void calcHistogram(const cv::Mat& image, unsigned histogram[256], unsigned cumulative[256] = NULL, int bits = 0);
+	void calcHistogram(const cv::Mat& image, std::vector<unsigned>& histogram, int channel = HISTOGRAM_LUMA, int bins = 256, int bits = 0);
+	void histogramChart(const cv::Mat& image, cv::Mat& histogram, bool isCumulative = true, int bits = 0);
+
+	void histogramEqualization(const cv::Mat& image, cv::Mat& processed, bool isPerChannel = false);
+	void histogramEqualization(const cv::Mat& image, cv::Mat& processed, const StreamingHistogram& histogram);
+	void histogramEqualization(const StreamingHistogram& histogram, PointOpChain& chain);
+	void adaptiveHistogramEqualization(const cv::Mat& image, cv::Mat& processed, double clipLimit = 2.0, cv::Size tileGrid = cv::Size(8, 8));
 }
 
 #endif /* IP_UTILS_H */
@@ -8,6 +8,8 @@
 
 /* Include files */
 #include "iputils.h"
+#include "HistogramKernel.h"
+#include "Parallel.h"
 #include <iostream>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
@@ -17,51 +19,6 @@ using namespace std;
 
 namespace ip
 {
-	/*! Keep ("clamp") a value inside a specific range [min, max].
-	* 
-	* Sets values < min to min and values > max to max.
-	*
-	* \param value Value to clamp
-	* \param min Lower bound of the range
-	* \param max Upper bound of the range
-	* \return value clamped to [min, max]
-	*/
-	inline uchar clamp(int value, uchar min, uchar max)
-	{
-		if ((value >= min) && (value <= max))
-			return value;
-		else
-			return (value < min) ? min : max;
-	}
-
-	/*! Clamp pixel values to be within [min, max].
-	* 
-	* All values < min will be set to min.
-	* All values > max will be set to max.
-	* 
-	* \param image Image with pixels to clamp
-	* \param min Minimum value
-	* \param max Maximum value
-	*/
-	void clamp(cv::Mat& image, uchar min, uchar max)
-	{
-		// 8-bit grayscale
-		if (image.type() == CV_8U) {
-			for (int y = 0; y < image.rows; y++) {
-				uchar* data = image.ptr<uchar>(y);
-
-				for (int x = 0; x < image.cols; x++) {
-					if (data[x] < min)
-						data[x] = min;
-					else if (data[x] > max)
-						data[x] = max;
-				}
-			}
-		}
-		else
-			cout << "[WARNING] Pixel type not supported in clamp()" << endl;
-	}
-
 	/*! Determine the maximum value inside an array.
 	* 
 	* \param values Array to search for maximum value
@@ -80,45 +37,65 @@ namespace ip
 
 	/*! Calculate the histogram data for 8-bit grayscale images.
 	* 
-	* \param image Image to calculate histogram for (8-bit grayscale)
+	* Rows are counted in parallel into interleaved sub-histograms (see countHistogram()).
+	* Color images are counted by their luma, 16-bit images by the 8 most significant bits.
+	* 
+	* \param image Image to calculate histogram for (8-bit grayscale, or BGR and/or 16 bit)
 	* \param histogram Array to store histogram data in
+	* \param cumulative Array to store cumulative histogram data in (optional)
+	* \param bits Significant bits of 16-bit images, e. g., 12 for Mono12 (0: 8 or 16 by image depth)
 	*/
-	void calcHistogram(const cv::Mat& image, unsigned histogram[256]) {
-		const int NUMBER_BINS = 256;
-
-		// Check for correct image type (8-bit grayscale)
-		if (image.type() != CV_8U)
+	void calcHistogram(const cv::Mat& image, unsigned histogram[256], unsigned cumulative[256], int bits) {
+		// 8-bit grayscale
+		if (image.type() == CV_8U) {
+			countHistogram(image, histogram, cumulative);
 			return;
+		}
 
-		// Init array
-		for (int i = 0; i < NUMBER_BINS; i++)
-			histogram[i] = 0;
+		// Luma of color images and/or 16-bit images
+		vector<unsigned> hist;
+		calcHistogram(image, hist, HISTOGRAM_LUMA, 256, bits);
 
-		// Count pixel values
-		for (int y = 0; y < image.rows; y++) {
-			const uchar* data = image.ptr<uchar>(y);
-			for (int x = 0; x < image.cols; x++) {
-				histogram[data[x]]++;
-			}
-		}
+		for (int g = 0; g < 256; g++)
+			histogram[g] = hist[g];
+		if (cumulative != NULL)
+			cumulateHistogram(histogram, cumulative);
+	}
+
+	/*! Calculate the histogram of one channel (or the luma) of an 8-bit or 16-bit image.
+	* 
+	* 16-bit images may use up to 65536 bins (one bin per value, see sparseHistogram() to list
+	* the occupied bins only) or fewer, wider bins.
+	* 
+	* \param image Image to calculate histogram for (depth CV_8U or CV_16U, one or three channels)
+	* \param histogram Vector to store histogram data in (resized to bins)
+	* \param channel Channel index or HISTOGRAM_LUMA (luma of BGR images)
+	* \param bins Number of bins (power of 2)
+	* \param bits Significant bits, e. g., 10 for Mono10 (0: 8 or 16 by image depth)
+	*/
+	void calcHistogram(const cv::Mat& image, vector<unsigned>& histogram, int channel, int bins, int bits) {
+		countHistogram(image, histogram, channel, bins, bits);
 	}
 
 	/*! Create an image depicting the histogram of a 8-bit grayscale image.
 	*
+	* Color images are charted by their luma, 16-bit images by the 8 most significant bits.
+	*
 	* \param image Image to create histogram for
 	* \param histogram Resulting histogram chart
+	* \param bits Significant bits of 16-bit images (0: 16)
 	*/
-	void histogramChart(const cv::Mat& image, cv::Mat& histImage)
+	void histogramChart(const cv::Mat& image, cv::Mat& histImage, int bits)
 	{
 		const int NUMBER_BINS = 256;
 
-		// Check for correct image type (8-bit grayscale)
-		if (image.type() != CV_8U)
+		// Check for correct image depth (8 or 16 bit)
+		if ((image.depth() != CV_8U) && (image.depth() != CV_16U))
 			return;
 
 		// Init array and count pixels
 		unsigned histogram[NUMBER_BINS] = { 0 };
-		calcHistogram(image, histogram);
+		calcHistogram(image, histogram, NULL, bits);
 
 		// Find maximum histogram value
 		unsigned maxCount = max(histogram, NUMBER_BINS);
@@ -143,47 +120,127 @@ namespace ip
 	*/
 	void maximizeContrast(const cv::Mat& image, cv::Mat& processed, double p)
 	{
-		const int NUMBER_BINS = 256;
-
 		// Check for correct image type (8-bit grayscale)
 		if (image.type() != CV_8U)
 			return;
 
-		// Calculate histogram
-		unsigned histogram[NUMBER_BINS] = { 0 };
-		calcHistogram(image, histogram);
+		// Calculate histogram and apply contrast maximization
+		StreamingHistogram histogram(image);
+		maximizeContrast(image, processed, histogram, p);
+	}
 
-		// Find min and max values ignoring p percent of pixels, each
-		unsigned numberPixels = (unsigned)image.rows * image.cols;
+	/*! Find min and max values ignoring p percent of the pixels of a histogram, each.
+	*
+	* \param histogram Histogram
+	* \param p Number of pixels to ignore at min and max, each [%]
+	* \param min [out] Lowest value not ignored
+	* \param max [out] Highest value not ignored (at least min + 1)
+	*/
+	static void contrastRange(const StreamingHistogram& histogram, double p, int& min, int& max)
+	{
+		unsigned numberPixels = histogram.count();
 		unsigned quantileCount = (unsigned)((p / 100.0) * numberPixels);
-		unsigned minCount = quantileCount + 1;
-		unsigned maxCount = numberPixels - quantileCount;
 
-		unsigned cumulative = 0;
-		int min = 0, max = NUMBER_BINS;
+		min = histogram.valueAtCount(quantileCount + 1);
+		max = std::max(histogram.valueAtCount(numberPixels - quantileCount), min + 1);
+	}
 
-		for (int i = 0; i < NUMBER_BINS; i++) {
-			cumulative += histogram[i];
-			if (cumulative >= minCount) {
-				min = i;
-				break;
-			}
-		}
-		for (int i = min + 1; i < NUMBER_BINS; i++) {
-			cumulative += histogram[i];
-			if (cumulative >= maxCount) {
-				max = i;
-				break;
-			}
-		}
+	/*! Apply contrast maximization to an 8-bit grayscale image based on a given histogram.
+	*
+	* The histogram may be of another region than the image, e. g., of a sliding window over
+	* the recent frames of a video or of a tile around the image.
+	*
+	* \param image Source image to apply contrast maximization to
+	* \param processed Destination image (may be empty when passed to the method)
+	* \param histogram Histogram to determine min and max from
+	* \param p Number of pixels to ignore at min and max, each [%]
+	*/
+	void maximizeContrast(const cv::Mat& image, cv::Mat& processed, const StreamingHistogram& histogram, double p)
+	{
+		// Check for correct image type (8-bit grayscale)
+		if (image.type() != CV_8U)
+			return;
 
 		// Create and apply LUT
-		cv::Mat lut(1, 256, CV_8U);
+		PointOpChain chain;
+		maximizeContrast(histogram, p, chain);
+		chain.apply(image, processed);
+	}
+
+	/*! Append contrast maximization based on a histogram to a chain of point operations.
+	*
+	* Further point operations (e. g., inversion or clamping) can be appended to the chain
+	* before it is applied to the image in a single pass.
+	*
+	* \param histogram Histogram to determine min and max from
+	* \param p Number of pixels to ignore at min and max, each [%]
+	* \param chain Chain of point operations to append contrast stretching to
+	*/
+	void maximizeContrast(const StreamingHistogram& histogram, double p, PointOpChain& chain)
+	{
+		// Find min and max values ignoring p percent of pixels, each
+		int min, max;
+		contrastRange(histogram, p, min, max);
 
-		for (int g = 0; g < 256; g++) {
-			int value = (int)(255.0 * ((double)g - min) / ((double)max - min) + 0.5);
-			lut.at<uchar>(g) = clamp(value, 0, 255);
+		chain.stretch(min, max);
+	}
+
+	/*! Apply contrast maximization with min and max of a sliding window around each pixel.
+	*
+	* The histogram of the window is updated incrementally: Moving one pixel to the right adds
+	* the window column entering and removes the column leaving, so the costs per pixel are
+	* O(windowSize) instead of O(windowSize^2). Windows are clipped at the image borders.
+	*
+	* \param image Source image to apply contrast maximization to
+	* \param processed Destination image (may be empty when passed to the method)
+	* \param windowSize Width and height of the window (odd)
+	* \param p Number of pixels to ignore at min and max, each [%]
+	*/
+	void maximizeContrastLocal(const cv::Mat& image, cv::Mat& processed, int windowSize, double p)
+	{
+		// Check for correct image type (8-bit grayscale) and window size
+		if (image.type() != CV_8U)
+			return;
+		if ((windowSize < 1) || ((windowSize % 2) == 0)) {
+			cout << "[WARNING] Window size must be odd and positive." << endl;
+			return;
 		}
-		cv::LUT(image, lut, processed);
+
+		int k = windowSize / 2;
+		cv::Mat source = (image.data == processed.data) ? image.clone() : image;
+		processed.create(image.rows, image.cols, CV_8U);
+
+		parallelRows(image.rows, k, [&](const RowBand& band) {
+			StreamingHistogram histogram;
+
+			for (int y = band.rowBegin; y < band.rowEnd; y++) {
+				int top = std::max(y - k, 0), bottom = std::min(y + k + 1, source.rows);
+				uchar* dstRow = processed.ptr<uchar>(y);
+
+				// Window at x = 0
+				histogram.clear();
+				histogram.add(source(cv::Range(top, bottom), cv::Range(0, std::min(k + 1, source.cols))));
+
+				for (int x = 0; x < source.cols; x++) {
+					// Slide window: add column x + k, remove column x - k - 1
+					if (x > 0) {
+						for (int v = top; v < bottom; v++) {
+							const uchar* srcRow = source.ptr<uchar>(v);
+
+							if (x + k < source.cols)
+								histogram.add(srcRow[x + k]);
+							if (x - k - 1 >= 0)
+								histogram.remove(srcRow[x - k - 1]);
+						}
+					}
+
+					int min, max;
+					contrastRange(histogram, p, min, max);
+
+					int value = (int)(255.0 * ((double)source.at<uchar>(y, x) - min) / ((double)max - min) + 0.5);
+					dstRow[x] = clamp(value, 0, 255);
+				}
+			}
+		});
 	}
 }
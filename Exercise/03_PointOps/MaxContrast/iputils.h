@@ -10,19 +10,25 @@
 #define IP_UTILS_H
 
 /* Include files */
+#include <vector>
 #include <opencv2/core/core.hpp>
+#include "Clamp.h"
+#include "HistogramKernel.h"
+#include "PointOpChain.h"
+#include "StreamingHistogram.h"
 
 namespace ip
 {
 	/* Prototypes */
-	inline uchar clamp(int value, uchar min, uchar max);
-	void clamp(cv::Mat& image, uchar min, uchar max);
-
 	unsigned max(unsigned values[], int size);
-	void calcHistogram(const cv::Mat& image, unsigned histogram[256]);
-	void histogramChart(const cv::Mat& image, cv::Mat& histogram);
+	void calcHistogram(const cv::Mat& image, unsigned histogram[256], unsigned cumulative[256] = NULL, int bits = 0);
+	void calcHistogram(const cv::Mat& image, std::vector<unsigned>& histogram, int channel = HISTOGRAM_LUMA, int bins = 256, int bits = 0);
+	void histogramChart(const cv::Mat& image, cv::Mat& histogram, int bits = 0);
 
 	void maximizeContrast(const cv::Mat& image, cv::Mat& processed, double p = 0.0);
+	void maximizeContrast(const cv::Mat& image, cv::Mat& processed, const StreamingHistogram& histogram, double p = 0.0);
+	void maximizeContrast(const StreamingHistogram& histogram, double p, PointOpChain& chain);
+	void maximizeContrastLocal(const cv::Mat& image, cv::Mat& processed, int windowSize, double p = 0.0);
 }
 
 #endif /* IP_UTILS_H */
@@ -12,17 +12,21 @@
 #include <iostream>
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
+#include "BorderAccessor.h"
+#include "SimdKernels.h"
 
 /* Defines */
 #define IMAGE_DATA_PATH getenv("ImagingData")			// Read environment variable ImagingData
 #define INPUT_IMAGE_RELATIVE_PATH "/Images/Docks.jpg"	// Image file including relative path
+#define BORDER_MODE ip::BORDER_CLAMP
 #define WRITE_IMAGE_FILES 0
 
 /* Namespaces */
 using namespace std;
 
 /* Prototypes */
-void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered);
+void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered, ip::BorderMode border = ip::BORDER_CLAMP);
+template <ip::BorderMode Mode> void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered);
 
 /* Main function */
 int main()
@@ -38,7 +42,7 @@ int main()
 
 	// Apply box filter
 	cv::Mat filtered;
-	binomialFilter3x3(image, filtered);
+	binomialFilter3x3(image, filtered, BORDER_MODE);
 
 	// Display images in named windows
 	cv::imshow("Image", image);
@@ -57,41 +61,78 @@ int main()
 
 /*! Apply 3x3 binomial filter.
 *
-* No border handling is applied.
+* Border handling: Pixels outside the image are extended according to the border mode
+* (clamp by default). No padded copy of the image is created.
 *
 * \param image Source image to be filtered
 * \param filtered Destination image
+* \param border Border extension mode
 */
+void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered, ip::BorderMode border)
+{
+	// Assert correct parameters
+	if (image.type() != CV_8U) {
+		cout << "[WARNING] Incorrect image type. CV_8U expected." << endl;
+		filtered = image.clone();
+		return;
+	}
+
+	// Keep source intact when filtering in place
+	cv::Mat source = (image.data == filtered.data) ? image.clone() : image;
+	filtered.create(image.rows, image.cols, CV_8U);
+
+	// Select implementation for border mode
+	switch (border) {
+	case ip::BORDER_ZERO:
+		binomialFilter3x3<ip::BORDER_ZERO>(source, filtered);
+		break;
+	case ip::BORDER_WRAP:
+		binomialFilter3x3<ip::BORDER_WRAP>(source, filtered);
+		break;
+	case ip::BORDER_REFLECT:
+		binomialFilter3x3<ip::BORDER_REFLECT>(source, filtered);
+		break;
+	default:
+		binomialFilter3x3<ip::BORDER_CLAMP>(source, filtered);
+	}
+}
+
+/*! Apply 3x3 binomial filter for a given border mode.
+*
+* The interior is filtered row by row with direct pixel access (vectorized by the SIMD
+* row kernel). Only the one pixel wide border strips are read through the border accessor.
+*
+* \param image Source image to be filtered (type CV_8U, not the destination image)
+* \param filtered Destination image (allocated with size of source image)
+*/
+template <ip::BorderMode Mode>
 void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered)
 {
 	int kernel[3][3] = {{1, 2, 1}, {2, 4, 2}, {1, 2, 1}};
 	int k = 1;
 	double kernelSum = 16;
+	ip::BorderAccessor<Mode> source(image);
 
-	// Init filtered image as clone
-	filtered = image.clone();
+	// Run through image (except for border) row by row (SSE2/AVX2 if available)
+	for (int y = k; y < image.rows - k; y++) {
+		uchar* dstRow = filtered.ptr<uchar>(y);
 
-	// Assert correct parameters
-	if (image.type() != CV_8U) {
-		cout << "[WARNING] Incorrect image type. CV_8U expected." << endl;
-		return;
+		if (image.cols > 2 * k)
+			ip::binomialRow3x3(image.ptr<uchar>(y - 1) + k, image.ptr<uchar>(y) + k, image.ptr<uchar>(y + 1) + k, dstRow + k, image.cols - 2 * k);
 	}
 
-	// Run through image (except for border)
-	for (int y = k; y < image.rows - k; y++) {
+	// Run through border strips (first and last row, first and last column)
+	for (int y = 0; y < image.rows; y++) {
 		uchar* dstRow = filtered.ptr<uchar>(y);
+		bool isBorderRow = (y < k) || (y >= image.rows - k);
+		int xStep = isBorderRow ? 1 : max(image.cols - 1, 1);
 
-		for (int x = k; x < image.cols - k; x++) {
+		for (int x = 0; x < image.cols; x += xStep) {
 			int sum = 0;
 
-			// Run through filter kernel
-			for (int n = y - k; n <= y + k; n++) {
-				const uchar* srcRow = image.ptr<uchar>(n);
-				int *h = &(kernel[n - (y - k)][k]);		// Center of correct kernel row
-
-				for (int m = x - k; m <= x + k; m++) {
-					sum += srcRow[m] * h[m - x];
-				}
+			for (int n = -k; n <= k; n++) {
+				for (int m = -k; m <= k; m++)
+					sum += source.at(y + n, x + m) * kernel[n + k][m + k];
 			}
 			dstRow[x] = (uchar)(sum / kernelSum + 0.5);
 		}
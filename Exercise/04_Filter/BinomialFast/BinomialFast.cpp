@@ -11,19 +11,26 @@
 
 /* Include files */
 #include <iostream>
+#include <vector>
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
+#include "BorderAccessor.h"
+#include "BinomialFilter.h"
+#include "SimdKernels.h"
 
 /* Defines */
 #define IMAGE_DATA_PATH getenv("ImagingData")			// Read environment variable ImagingData
 #define INPUT_IMAGE_RELATIVE_PATH "/Images/Docks.jpg"	// Image file including relative path
+#define BORDER_MODE ip::BORDER_CLAMP
+#define KERNEL_SIZE 9								// Kernel size of the generic binomial filter
 #define WRITE_IMAGE_FILES 0
 
 /* Namespaces */
 using namespace std;
 
 /* Prototypes */
-void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered);
+void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered, ip::BorderMode border = ip::BORDER_CLAMP);
+template <ip::BorderMode Mode> void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered);
 
 /* Main function */
 int main()
@@ -37,13 +44,15 @@ int main()
 		return 0;
 	}
 
-	// Apply box filter
-	cv::Mat filtered;
-	binomialFilter3x3(image, filtered);
+	// Apply binomial filters
+	cv::Mat filtered, filteredKxK;
+	binomialFilter3x3(image, filtered, BORDER_MODE);
+	ip::binomialFilter(image, filteredKxK, KERNEL_SIZE, BORDER_MODE);
 
 	// Display images in named windows
 	cv::imshow("Image", image);
 	cv::imshow("Binomial filter", filtered);
+	cv::imshow("Binomial filter (KxK)", filteredKxK);
 
 #if WRITE_IMAGE_FILES == 1
 	// Write images to file
@@ -58,12 +67,14 @@ int main()
 
 /*! Apply 3x3 binomial filter.
 *
-* No border handling is applied.
+* Border handling: Pixels outside the image are extended according to the border mode
+* (clamp by default). No padded copy of the image is created.
 *
 * \param image Source image to be filtered
 * \param filtered Destination image
+* \param border Border extension mode
 */
-void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered)
+void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered, ip::BorderMode border)
 {
 	// Assert correct parameters
 	if (image.type() != CV_8U) {
@@ -71,29 +82,66 @@ void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered)
 		return;
 	}
 
-	// 1D filter in x-direction (except for border)
-	cv::Mat filteredX = image.clone();
-	for (int y = 1; y < image.rows - 1; y++) {
-		const uchar* srcRow = image.ptr<uchar>(y);
-		uchar* dstRow = filteredX.ptr<uchar>(y);
-
-		for (int x = 1; x < image.cols - 1; x++) {
-			int sum = (int)srcRow[x - 1] + ((int)srcRow[x] << 1) + (int)srcRow[x + 1];
-			dstRow[x] = (uchar)(sum >> 2);
-		}
+	// Keep source intact when filtering in place
+	cv::Mat source = (image.data == filtered.data) ? image.clone() : image;
+	filtered.create(image.rows, image.cols, CV_8U);
+
+	// Select implementation for border mode
+	switch (border) {
+	case ip::BORDER_ZERO:
+		binomialFilter3x3<ip::BORDER_ZERO>(source, filtered);
+		break;
+	case ip::BORDER_WRAP:
+		binomialFilter3x3<ip::BORDER_WRAP>(source, filtered);
+		break;
+	case ip::BORDER_REFLECT:
+		binomialFilter3x3<ip::BORDER_REFLECT>(source, filtered);
+		break;
+	default:
+		binomialFilter3x3<ip::BORDER_CLAMP>(source, filtered);
 	}
+}
 
-	// 1D filter in y-direction (except for border)
-	filtered = filteredX.clone();
-	for (int y = 1; y < image.rows - 1; y++) {
-		const uchar* srcRow1 = filteredX.ptr<uchar>(y - 1);
-		const uchar* srcRow2 = filteredX.ptr<uchar>(y);
-		const uchar* srcRow3 = filteredX.ptr<uchar>(y + 1);
+/*! Apply separable 3x3 binomial filter for a given border mode in a single pass.
+*
+* The horizontal pass writes into a ring buffer of 3 rows. As soon as the rows above
+* and below the current row are available, the vertical pass writes the result directly
+* into the destination image. Each source row is read once and the intermediate memory
+* is 3 rows instead of a full image. Both passes divide by 4 by a shift (truncation) and
+* run as SIMD row kernels (SSE2/AVX2 if available).
+*
+* \param image Source image to be filtered (type CV_8U, not the destination image)
+* \param filtered Destination image (allocated with size of source image)
+*/
+template <ip::BorderMode Mode>
+void binomialFilter3x3(const cv::Mat& image, cv::Mat& filtered)
+{
+	ip::BorderAccessor<Mode> source(image);
+	size_t cols = image.cols;
+	vector<uchar> line(cols + 2), ring(3 * cols);
+
+	// 1D filter in x-direction of one (extended) row into its ring buffer row
+	auto filterRowX = [&](int y) {
+		const uchar* srcRow = line.data() + 1;
+		uchar* dstRow = &ring[((y + 1) % 3) * cols];
+
+		source.paddedRow(y, 1, line.data());
+		ip::binomialRow121(srcRow - 1, srcRow, srcRow + 1, dstRow, image.cols);
+	};
+
+	// Fill ring buffer with rows -1 and 0
+	filterRowX(-1);
+	filterRowX(0);
+
+	// 1D filter in y-direction on ring buffer rows y - 1, y, y + 1
+	for (int y = 0; y < image.rows; y++) {
+		filterRowX(y + 1);
+
+		const uchar* srcRow1 = &ring[(y % 3) * cols];
+		const uchar* srcRow2 = &ring[((y + 1) % 3) * cols];
+		const uchar* srcRow3 = &ring[((y + 2) % 3) * cols];
 		uchar* dstRow = filtered.ptr<uchar>(y);
 
-		for (int x = 1; x < image.cols - 1; x++) {
-			int sum = (int)srcRow1[x] + ((int)srcRow2[x] << 1) + (int)srcRow3[x];
-			dstRow[x] = (uchar)(sum >> 2);
-		}
+		ip::binomialRow121(srcRow1, srcRow2, srcRow3, dstRow, image.cols);
 	}
 }
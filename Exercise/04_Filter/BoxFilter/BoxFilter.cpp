@@ -10,20 +10,31 @@
 
 /* Include files */
 #include <iostream>
+#include <cstdint>						// Declare uint64_t
+#include <vector>
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
+#include "BorderAccessor.h"
+#include "IntegralImage.h"
+#include "Parallel.h"
 
 /* Defines */
 #define IMAGE_DATA_PATH getenv("ImagingData")			// Read environment variable ImagingData
 #define INPUT_IMAGE_RELATIVE_PATH "/Images/Docks.jpg"	// Image file including relative path
 #define KERNEL_SIZE 7
+#define BORDER_MODE ip::BORDER_CLAMP
 #define WRITE_IMAGE_FILES 0
+#define RUN_BENCHMARK 0								// Compare runtimes of naive, running-sum, and integral image filter
 
 /* Namespaces */
 using namespace std;
 
 /* Prototypes */
-void boxFilter(const cv::Mat& image, cv::Mat& filtered, int kernelSize);
+void boxFilter(const cv::Mat& image, cv::Mat& filtered, int kernelSize, ip::BorderMode border = ip::BORDER_CLAMP);
+template <ip::BorderMode Mode> void boxFilterRunningSums(const cv::Mat& image, cv::Mat& filtered, int kernelSize);
+void boxFilter(const cv::Mat& image, const ip::IntegralImage& integral, cv::Mat& filtered, int kernelSize);
+void boxFilterNaive(const cv::Mat& image, cv::Mat& filtered, int kernelSize);
+void benchmarkBoxFilters(const cv::Mat& image);
 
 /* Main function */
 int main()
@@ -37,9 +48,14 @@ int main()
 		return 0;
 	}
 
+#if RUN_BENCHMARK == 1
+	// Measure runtimes for several kernel sizes
+	benchmarkBoxFilters(image);
+#endif
+
 	// Apply box filter
 	cv::Mat filtered;
-	boxFilter(image, filtered, KERNEL_SIZE);
+	boxFilter(image, filtered, KERNEL_SIZE, BORDER_MODE);
 
 	// Display images in named windows
 	cv::imshow("Image", image);
@@ -48,7 +64,7 @@ int main()
 #if WRITE_IMAGE_FILES == 1
 	// Write images to file
 	cv::imwrite("D:/Gray.jpg", image);
-	cv::imwrite("D:/BoxNoBorder.jpg", filtered);
+	cv::imwrite("D:/Box.jpg", filtered);
 #endif
 
 	// Wait for keypress and terminate
@@ -57,14 +73,207 @@ int main()
 }
 
 /*! Apply 2D box filter.
+*
+* The filter is implemented as separable sliding window:
+* - Running column sums hold the vertical sums of K rows for each column. Moving to the
+*   next row adds the entering row and subtracts the leaving row.
+* - A running row sum over these column sums yields the sum of the KxK neighborhood.
+*   Moving to the next column adds the entering and subtracts the leaving column sum.
+* 
+* Hence, each pixel costs a constant number of operations independent of the kernel size.
+* 
+* Border handling: Pixels outside the image are extended according to the border mode
+* (clamp by default). No padded copy of the image is created.
+* 
+* \param image Source image to be filtered
+* \param filtered Destination image
+* \param kernelSize Size K of the KxK filter kernel (must be odd)
+* \param border Border extension mode
+*/
+void boxFilter(const cv::Mat& image, cv::Mat& filtered, int kernelSize, ip::BorderMode border)
+{
+	// Assert correct parameters
+	if (image.type() != CV_8U) {
+		cout << "[WARNING] Incorrect image type. CV_8U expected." << endl;
+		filtered = image.clone();
+		return;
+	}
+	if ((kernelSize % 2) == 0) {
+		cout << "[WARNING] Kernel size must be odd." << endl;
+		filtered = image.clone();
+		return;
+	}
+
+	// Keep source intact when filtering in place
+	cv::Mat source = (image.data == filtered.data) ? image.clone() : image;
+	filtered.create(image.rows, image.cols, CV_8U);
+
+	// Select implementation for border mode
+	switch (border) {
+	case ip::BORDER_ZERO:
+		boxFilterRunningSums<ip::BORDER_ZERO>(source, filtered, kernelSize);
+		break;
+	case ip::BORDER_WRAP:
+		boxFilterRunningSums<ip::BORDER_WRAP>(source, filtered, kernelSize);
+		break;
+	case ip::BORDER_REFLECT:
+		boxFilterRunningSums<ip::BORDER_REFLECT>(source, filtered, kernelSize);
+		break;
+	default:
+		boxFilterRunningSums<ip::BORDER_CLAMP>(source, filtered, kernelSize);
+	}
+}
+
+/*! Apply 2D box filter using running sums for a given border mode.
+*
+* Rows outside the image are read through the border accessor, column sums outside
+* the image are extended from the inner column sums. Both only affect the border strips.
+*
+* The image is split into horizontal bands filtered in parallel. Each band initializes
+* its column sums from the k rows above it (halo), so bands are at least 2K rows high.
+*
+* \param image Source image to be filtered (type CV_8U, not the destination image)
+* \param filtered Destination image (allocated with size of source image)
+* \param kernelSize Size K of the KxK filter kernel (must be odd)
+*/
+template <ip::BorderMode Mode>
+void boxFilterRunningSums(const cv::Mat& image, cv::Mat& filtered, int kernelSize)
+{
+	int k = kernelSize / 2;
+	int kernelArea = kernelSize * kernelSize;
+	ip::BorderAccessor<Mode> source(image);
+
+	// Division by kernel area as multiplication by a fixed-point reciprocal
+	// (exact for sums < 2^48 / area, i. e., kernels up to 1023x1023)
+	bool isReciprocalExact = (kernelArea < (1 << 20));
+	uint64_t reciprocal = ((uint64_t)1 << 48) / kernelArea + 1;
+
+	ip::parallelRows(image.rows, k, [&](const ip::RowBand& band) {
+		// Column sums padded by k + 1 columns on each side (the last one on the right
+		// is read by the last, unused running sum update)
+		vector<int> paddedSums(image.cols + 2 * (k + 1), 0);
+		int* colSums = paddedSums.data() + k + 1;
+
+		// Init column sums with rows rowBegin - k .. rowBegin + k
+		for (int n = band.rowBegin - k; n <= band.rowBegin + k; n++) {
+			const uchar* srcRow = source.row(n);
+
+			for (int x = 0; x < image.cols; x++)
+				colSums[x] += srcRow[x];
+		}
+
+		// Run through band rows
+		for (int y = band.rowBegin; y < band.rowEnd; y++) {
+			uchar* dstRow = filtered.ptr<uchar>(y);
+
+			// Extend border column sums into padding
+			ip::BorderAccessor<Mode>::extendLine(colSums, image.cols, k + 1);
+
+			// Running row sum of column sums
+			int sum = 0;
+			for (int m = -k; m <= k; m++)
+				sum += colSums[m];
+
+			for (int x = 0; x < image.cols; x++) {
+				dstRow[x] = isReciprocalExact ? (uchar)((sum * reciprocal) >> 48) : (uchar)(sum / kernelArea);
+				sum += colSums[x + k + 1] - colSums[x - k];
+			}
+
+			// Move column sums to next row (remove row y - k, add row y + k + 1)
+			if (y < band.rowEnd - 1) {
+				const uchar* leavingRow = source.row(y - k);
+				const uchar* enteringRow = source.row(y + k + 1);
+
+				for (int x = 0; x < image.cols; x++)
+					colSums[x] += (int)enteringRow[x] - (int)leavingRow[x];
+			}
+		}
+	}, 2 * kernelSize);
+}
+
+/*! Apply 2D box filter using a precomputed integral image.
+*
+* Each KxK neighborhood sum is read from the integral image in O(1). This is useful
+* whenever the integral image of the frame is built anyway for other operations.
+*
+* Border handling is identical to the running-sum filter with clamp border: Replicated border
+* rows, columns, and corners are added as multiples of integral image row and column sums.
+*
+* \param image Source image to be filtered
+* \param integral Integral image of the source image
+* \param filtered Destination image
+* \param kernelSize Size K of the KxK filter kernel (must be odd)
+*/
+void boxFilter(const cv::Mat& image, const ip::IntegralImage& integral, cv::Mat& filtered, int kernelSize)
+{
+	int k = kernelSize / 2;
+	int kernelArea = kernelSize * kernelSize;
+
+	// Assert correct parameters
+	if (image.type() != CV_8U) {
+		cout << "[WARNING] Incorrect image type. CV_8U expected." << endl;
+		filtered = image.clone();
+		return;
+	}
+	if ((kernelSize % 2) == 0) {
+		cout << "[WARNING] Kernel size must be odd." << endl;
+		filtered = image.clone();
+		return;
+	}
+	if (integral.size() != image.size()) {
+		cout << "[WARNING] Integral image does not match image size." << endl;
+		filtered = image.clone();
+		return;
+	}
+
+	// Keep source intact when filtering in place
+	cv::Mat source = (image.data == filtered.data) ? image.clone() : image;
+	filtered.create(image.rows, image.cols, CV_8U);
+
+	// Division by kernel area as multiplication by a fixed-point reciprocal (see above)
+	bool isReciprocalExact = (kernelArea < (1 << 20));
+	uint64_t reciprocal = ((uint64_t)1 << 48) / kernelArea + 1;
+	int lastX = image.cols - 1, lastY = image.rows - 1;
+
+	// Run through image rows
+	for (int y = 0; y < image.rows; y++) {
+		uchar* dstRow = filtered.ptr<uchar>(y);
+		int top = max(y - k, 0), bottom = min(y + k, lastY);
+		int height = bottom - top + 1;
+		int topCopies = top - (y - k), bottomCopies = (y + k) - bottom;
+
+		for (int x = 0; x < image.cols; x++) {
+			int left = max(x - k, 0), right = min(x + k, lastX);
+			int width = right - left + 1;
+			uint64_t sum = integral.sum(left, top, width, height);
+
+			// Add replicated pixels outside the image (clamp)
+			if (topCopies > 0 || bottomCopies > 0 || width < kernelSize) {
+				int leftCopies = left - (x - k), rightCopies = (x + k) - right;
+
+				sum += topCopies * integral.sum(left, 0, width, 1);
+				sum += bottomCopies * integral.sum(left, lastY, width, 1);
+				sum += leftCopies * integral.sum(0, top, 1, height);
+				sum += rightCopies * integral.sum(lastX, top, 1, height);
+				sum += topCopies * (leftCopies * source.at<uchar>(0, 0) + rightCopies * source.at<uchar>(0, lastX));
+				sum += bottomCopies * (leftCopies * source.at<uchar>(lastY, 0) + rightCopies * source.at<uchar>(lastY, lastX));
+			}
+
+			dstRow[x] = isReciprocalExact ? (uchar)((sum * reciprocal) >> 48) : (uchar)(sum / kernelArea);
+		}
+	}
+}
+
+/*! Apply 2D box filter by summing all kernel elements for each pixel.
 * 
+* Straightforward reference implementation with costs O(K^2) per pixel.
 * No border handling is applied.
 * 
 * \param image Source image to be filtered
 * \param filtered Destination image
 * \param kernelSize Size K of the KxK filter kernel (must be odd)
 */
-void boxFilter(const cv::Mat& image, cv::Mat& filtered, int kernelSize)
+void boxFilterNaive(const cv::Mat& image, cv::Mat& filtered, int kernelSize)
 {
 	int k = kernelSize / 2;
 	double kernelSum = (double)kernelSize * kernelSize;
@@ -101,3 +310,42 @@ void boxFilter(const cv::Mat& image, cv::Mat& filtered, int kernelSize)
 		}
 	}
 }
+
+/*! Measure and print runtimes of naive, running-sum, and integral image box filters.
+* 
+* The runtimes are listed for increasing kernel sizes. The running-sum and integral image
+* implementations are expected to be (almost) independent of the kernel size. The integral
+* image is built once outside the loop (as shared by several operations on the same frame),
+* its construction time is printed separately.
+* 
+* \param image Source image to be filtered
+*/
+void benchmarkBoxFilters(const cv::Mat& image)
+{
+	const int KERNEL_SIZES[] = { 3, 5, 7, 11, 15, 21, 31, 51 };
+	cv::Mat filtered;
+
+	int64 start = cv::getTickCount();
+	ip::IntegralImage integral(image, false);
+	double integralMs = 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency();
+
+	cout << "Box filter runtimes for " << image.cols << "x" << image.rows << " image:" << endl;
+	cout << "(Building integral image: " << integralMs << " ms)" << endl;
+	cout << "Kernel\tNaive [ms]\tRunning sum [ms]\tIntegral image [ms]" << endl;
+
+	for (int kernelSize : KERNEL_SIZES) {
+		start = cv::getTickCount();
+		boxFilterNaive(image, filtered, kernelSize);
+		double naiveMs = 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency();
+
+		start = cv::getTickCount();
+		boxFilter(image, filtered, kernelSize);
+		double runningMs = 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency();
+
+		start = cv::getTickCount();
+		boxFilter(image, integral, filtered, kernelSize);
+		double integralFilterMs = 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency();
+
+		cout << kernelSize << "x" << kernelSize << "\t" << naiveMs << "\t\t" << runningMs << "\t\t\t" << integralFilterMs << endl;
+	}
+}
@@ -12,6 +12,7 @@
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
+#include "Filter.h"
 
 /* Defines */
 #define IMAGE_DATA_PATH getenv("ImagingData")			// Read environment variable ImagingData
@@ -20,12 +21,14 @@
 #define PERCENTAGE_SALT 0.5
 #define PERCENTAGE_PEPPER 0.5
 #define WRITE_IMAGE_FILES 1
+#define RUN_BENCHMARK 0								// Compare ip::medianFilter() with cv::medianBlur()
 
 /* Namespaces */
 using namespace std;
 
 /* Prototypes */
 void addSaltAndPepperNoise(const cv::Mat& image, cv::Mat& corrupted, double saltPercent, double pepperPercent);
+void compareMedianFilters(const cv::Mat& image);
 
 /* Main function */
 int main()
@@ -39,10 +42,15 @@ int main()
 		return 0;
 	}
 
+#if RUN_BENCHMARK == 1
+	// Compare results and runtimes for several kernel sizes
+	compareMedianFilters(image);
+#endif
+
 	// Add salt & pepper noise and apply filter
 	cv::Mat noisy, denoised;
 	addSaltAndPepperNoise(image, noisy, PERCENTAGE_SALT, PERCENTAGE_PEPPER);
-	cv::medianBlur(noisy, denoised, KERNEL_SIZE);
+	ip::medianFilter(noisy, denoised, KERNEL_SIZE);
 
 	// Display images
 	cv::imshow("Image", image);
@@ -85,3 +93,36 @@ void addSaltAndPepperNoise(const cv::Mat& image, cv::Mat& corrupted, double salt
 		}
 	}
 }
+
+/*! Compare constant-time median filter with cv::medianBlur().
+*
+* For increasing kernel sizes, salt & pepper noise is added to the image and removed by
+* both filters. Runtimes and the number of differing pixels are printed (expected to be 0,
+* as both replicate border pixels).
+*
+* \param image Source image (type CV_8U)
+*/
+void compareMedianFilters(const cv::Mat& image)
+{
+	const int KERNEL_SIZES[] = { 3, 5, 7, 9, 11, 15, 21, 31 };
+	cv::Mat noisy, expected, filtered, differences;
+
+	cout << "Median filter comparison for " << image.cols << "x" << image.rows << " image:" << endl;
+	cout << "Kernel\tcv::medianBlur [ms]\tip::medianFilter [ms]\tDiffering pixels" << endl;
+
+	for (int kernelSize : KERNEL_SIZES) {
+		addSaltAndPepperNoise(image, noisy, PERCENTAGE_SALT, PERCENTAGE_PEPPER);
+
+		int64 start = cv::getTickCount();
+		cv::medianBlur(noisy, expected, kernelSize);
+		double openCvMs = 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency();
+
+		start = cv::getTickCount();
+		ip::medianFilter(noisy, filtered, kernelSize);
+		double constantTimeMs = 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency();
+
+		cv::compare(expected, filtered, differences, cv::CMP_NE);
+		cout << kernelSize << "x" << kernelSize << "\t" << openCvMs << "\t\t\t" << constantTimeMs
+			<< "\t\t\t" << cv::countNonZero(differences) << endl;
+	}
+}
@@ -9,19 +9,29 @@
 
 /* Include files */
 #include <iostream>
+#include <vector>
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
+#include "BorderAccessor.h"
+#include "SimdKernels.h"
 
 /* Defines */
 #define IMAGE_DATA_PATH getenv("ImagingData")			// Read environment variable ImagingData
 #define INPUT_IMAGE_RELATIVE_PATH "/Images/PCB.jpg"	// Image file including relative path
+#define KERNEL_WIDTH 3
+#define KERNEL_HEIGHT 3
+#define BORDER_MODE ip::BORDER_CLAMP
 #define WRITE_IMAGE_FILES 0
+#define RUN_BENCHMARK 0								// Compare runtimes of naive and van Herk/Gil-Werman filter
 
 /* Namespaces */
 using namespace std;
 
 /* Prototypes */
-void minMaxFilter(const cv::Mat& image, cv::Mat& minImage, cv::Mat& maxImage);
+void minMaxFilter(const cv::Mat& image, cv::Mat& minImage, cv::Mat& maxImage, cv::Size kernelSize, ip::BorderMode border = ip::BORDER_CLAMP);
+template <ip::BorderMode Mode> void minMaxFilterVanHerk(const cv::Mat& image, cv::Mat& minImage, cv::Mat& maxImage, cv::Size kernelSize);
+void minMaxFilterNaive(const cv::Mat& image, cv::Mat& minImage, cv::Mat& maxImage, cv::Size kernelSize);
+void benchmarkMinMaxFilters(const cv::Mat& image);
 
 /* Main function */
 int main()
@@ -35,9 +45,14 @@ int main()
 		return 0;
 	}
 
-	// Apply box filter
+#if RUN_BENCHMARK == 1
+	// Measure runtimes for several kernel sizes
+	benchmarkMinMaxFilters(image);
+#endif
+
+	// Apply minimum and maximum filter
 	cv::Mat minImage, maxImage;
-	minMaxFilter(image, minImage, maxImage);
+	minMaxFilter(image, minImage, maxImage, cv::Size(KERNEL_WIDTH, KERNEL_HEIGHT), BORDER_MODE);
 
 	// Display images in named windows
 	cv::imshow("Image", image);
@@ -56,15 +71,193 @@ int main()
 	return 0;
 }
 
-/*! Apply 3x3 minimum and maximum filters.
+/*! Apply van Herk/Gil-Werman minimum and maximum filter to one padded line.
+*
+* The padded line is split into blocks of the window size. Within each block, running
+* extrema are computed forward (prefix) and backward (suffix). The window starting at
+* i then covers the end of one block and the beginning of the next, hence its extremum
+* is the extremum of suffix[i] and prefix[i + window - 1]. This takes about 3 comparisons
+* per pixel and filter independent of the window size.
+*
+* \param minSrc Padded source line for the minimum (count + window - 1 elements)
+* \param maxSrc Padded source line for the maximum (count + window - 1 elements)
+* \param count Number of resulting pixels
+* \param window Window size
+* \param minDst Destination line for the minimum filter (count elements)
+* \param maxDst Destination line for the maximum filter (count elements)
+* \param buffers Work memory for prefix and suffix extrema (4 * (count + window - 1) elements)
+*/
+static void vanHerkLine(const uchar* minSrc, const uchar* maxSrc, int count, int window, uchar* minDst, uchar* maxDst, uchar* buffers)
+{
+	int length = count + window - 1;
+	uchar* prefixMin = buffers;
+	uchar* prefixMax = prefixMin + length;
+	uchar* suffixMin = prefixMax + length;
+	uchar* suffixMax = suffixMin + length;
+
+	// Running extrema within blocks (forward and backward)
+	for (int start = 0; start < length; start += window) {
+		int end = min(start + window, length) - 1;
+
+		prefixMin[start] = minSrc[start];
+		prefixMax[start] = maxSrc[start];
+		for (int i = start + 1; i <= end; i++) {
+			prefixMin[i] = min(prefixMin[i - 1], minSrc[i]);
+			prefixMax[i] = max(prefixMax[i - 1], maxSrc[i]);
+		}
+
+		suffixMin[end] = minSrc[end];
+		suffixMax[end] = maxSrc[end];
+		for (int i = end - 1; i >= start; i--) {
+			suffixMin[i] = min(suffixMin[i + 1], minSrc[i]);
+			suffixMax[i] = max(suffixMax[i + 1], maxSrc[i]);
+		}
+	}
+
+	// Merge suffix and prefix extrema of neighboring blocks
+	ip::minMaxRows(suffixMin, prefixMin + window - 1, suffixMax, prefixMax + window - 1, minDst, maxDst, count);
+}
+
+/*! Apply minimum and maximum filters with arbitrary rectangular window.
+*
+* Separable van Herk/Gil-Werman implementation: A vertical pass followed by a horizontal
+* pass, both with constant costs per pixel independent of the window size. Minimum and
+* maximum are computed in the same pass. The vertical pass processes complete rows to
+* run through memory sequentially. It streams blocks of the window height, so its scratch
+* memory is two blocks of rows instead of the whole image. Row-wise extrema (vertical pass
+* and merging) run as SIMD row kernels (SSE2/AVX2 if available), the horizontal running
+* extrema remain scalar, as each depends on its predecessor.
+*
+* Border handling: Pixels outside the image are extended according to the border mode.
+* The default clamp equals ignoring them, i. e., the result is identical to cv::erode()
+* and cv::dilate() with rectangular structuring element and default border.
 *
 * \param image Source image to be filtered
 * \param minImage Destination image for minimum filter
 * \param maxImage Destination image for maximum filter
+* \param kernelSize Window size (width and height must be odd)
+* \param border Border extension mode
 */
-void minMaxFilter(const cv::Mat& image, cv::Mat& minImage, cv::Mat& maxImage)
+void minMaxFilter(const cv::Mat& image, cv::Mat& minImage, cv::Mat& maxImage, cv::Size kernelSize, ip::BorderMode border)
 {
-	int k = 1;		// Half filter size
+	// Assert correct parameters
+	if (image.type() != CV_8U) {
+		cout << "[WARNING] Incorrect image type. CV_8U expected." << endl;
+		return;
+	}
+	if (((kernelSize.width % 2) == 0) || ((kernelSize.height % 2) == 0)) {
+		cout << "[WARNING] Kernel size must be odd." << endl;
+		minImage = image.clone();
+		maxImage = image.clone();
+		return;
+	}
+
+	// Keep source intact when filtering in place
+	cv::Mat source = ((image.data == minImage.data) || (image.data == maxImage.data)) ? image.clone() : image;
+	minImage.create(image.rows, image.cols, CV_8U);
+	maxImage.create(image.rows, image.cols, CV_8U);
+
+	// Select implementation for border mode
+	switch (border) {
+	case ip::BORDER_ZERO:
+		minMaxFilterVanHerk<ip::BORDER_ZERO>(source, minImage, maxImage, kernelSize);
+		break;
+	case ip::BORDER_WRAP:
+		minMaxFilterVanHerk<ip::BORDER_WRAP>(source, minImage, maxImage, kernelSize);
+		break;
+	case ip::BORDER_REFLECT:
+		minMaxFilterVanHerk<ip::BORDER_REFLECT>(source, minImage, maxImage, kernelSize);
+		break;
+	default:
+		minMaxFilterVanHerk<ip::BORDER_CLAMP>(source, minImage, maxImage, kernelSize);
+	}
+}
+
+/*! Apply van Herk/Gil-Werman minimum and maximum filters for a given border mode.
+*
+* Rows outside the image are read through the border accessor, the line buffers of the
+* horizontal pass are extended from their inner elements.
+*
+* \param image Source image to be filtered (type CV_8U, not a destination image)
+* \param minImage Destination image for minimum filter (allocated with size of source image)
+* \param maxImage Destination image for maximum filter (allocated with size of source image)
+* \param kernelSize Window size (width and height must be odd)
+*/
+template <ip::BorderMode Mode>
+void minMaxFilterVanHerk(const cv::Mat& image, cv::Mat& minImage, cv::Mat& maxImage, cv::Size kernelSize)
+{
+	int kx = kernelSize.width / 2, ky = kernelSize.height / 2, height = kernelSize.height;
+	ip::BorderAccessor<Mode> source(image);
+
+	// Vertical pass on extended rows -ky .. rows + ky - 1 in blocks of the window height. Output
+	// row start + j merges suffix row j of its own block with prefix row j - 1 of the next block,
+	// so the line buffers hold two blocks instead of the extended image.
+	size_t cols = image.cols;
+	vector<uchar> suffixMin(height * cols), suffixMax(height * cols);
+	vector<uchar> prefixMin(height * cols), prefixMax(height * cols);
+
+	// Line buffers of horizontal pass (padded by kx columns on each side)
+	int lineLength = image.cols + kernelSize.width - 1;
+	vector<uchar> minLine(lineLength), maxLine(lineLength), buffers(4 * lineLength);
+
+	for (int start = 0; start < image.rows; start += height) {
+		int count = min(height, image.rows - start);
+		const uchar* srcRow = source.row(start + height - 1 - ky);
+
+		// Running extrema backward through own block (always complete)
+		copy(srcRow, srcRow + cols, &suffixMin[(height - 1) * cols]);
+		copy(srcRow, srcRow + cols, &suffixMax[(height - 1) * cols]);
+		for (int i = height - 2; i >= 0; i--) {
+			srcRow = source.row(start + i - ky);
+			ip::minMaxRows(&suffixMin[(i + 1) * cols], srcRow, &suffixMax[(i + 1) * cols], srcRow,
+				&suffixMin[i * cols], &suffixMax[i * cols], image.cols);
+		}
+
+		// Running extrema forward through next block (as far as output rows of own block need them)
+		if (count > 1) {
+			srcRow = source.row(start + height - ky);
+			copy(srcRow, srcRow + cols, &prefixMin[0]);
+			copy(srcRow, srcRow + cols, &prefixMax[0]);
+		}
+		for (int i = 1; i < count - 1; i++) {
+			srcRow = source.row(start + height + i - ky);
+			ip::minMaxRows(&prefixMin[(i - 1) * cols], srcRow, &prefixMax[(i - 1) * cols], srcRow,
+				&prefixMin[i * cols], &prefixMax[i * cols], image.cols);
+		}
+
+		// Horizontal pass on vertical extrema of output rows
+		for (int j = 0; j < count; j++) {
+			const uchar* lowerMin = &suffixMin[j * cols];
+			const uchar* lowerMax = &suffixMax[j * cols];
+			const uchar* upperMin = j ? &prefixMin[(j - 1) * cols] : lowerMin;
+			const uchar* upperMax = j ? &prefixMax[(j - 1) * cols] : lowerMax;
+
+			// Merge vertical suffix and prefix extrema (first row of block covers the window alone)
+			ip::minMaxRows(lowerMin, upperMin, lowerMax, upperMax, &minLine[kx], &maxLine[kx], image.cols);
+
+			// Extend border pixels into padding
+			ip::BorderAccessor<Mode>::extendLine(minLine.data() + kx, image.cols, kx);
+			ip::BorderAccessor<Mode>::extendLine(maxLine.data() + kx, image.cols, kx);
+
+			vanHerkLine(minLine.data(), maxLine.data(), image.cols, kernelSize.width,
+				minImage.ptr<uchar>(start + j), maxImage.ptr<uchar>(start + j), buffers.data());
+		}
+	}
+}
+
+/*! Apply minimum and maximum filters by scanning the entire window for each pixel.
+*
+* Straightforward reference implementation with costs O(W * H) per pixel.
+* No border handling is applied.
+*
+* \param image Source image to be filtered
+* \param minImage Destination image for minimum filter
+* \param maxImage Destination image for maximum filter
+* \param kernelSize Window size (width and height must be odd)
+*/
+void minMaxFilterNaive(const cv::Mat& image, cv::Mat& minImage, cv::Mat& maxImage, cv::Size kernelSize)
+{
+	int kx = kernelSize.width / 2, ky = kernelSize.height / 2;
 
 	// Assert correct parameters
 	if (image.type() != CV_8U) {
@@ -77,25 +270,53 @@ void minMaxFilter(const cv::Mat& image, cv::Mat& minImage, cv::Mat& maxImage)
 	maxImage = image.clone();
 
 	// Run through image (except for border)
-	for (int y = 1; y < image.rows - k; y++) {
+	for (int y = ky; y < image.rows - ky; y++) {
 		uchar* minRow = minImage.ptr<uchar>(y);
 		uchar* maxRow = maxImage.ptr<uchar>(y);
 
-		for (int x = k; x < image.cols - k; x++) {
+		for (int x = kx; x < image.cols - kx; x++) {
 			minRow[x] = maxRow[x] = image.at<uchar>(y,x);
 
 			// Run through filter kernel
-			for (int n = -k; n <= k; n++) {
+			for (int n = -ky; n <= ky; n++) {
 				const uchar* srcRow = image.ptr<uchar>(y + n);
 
-				for (int m = -k; m <= k; m++) {
+				for (int m = -kx; m <= kx; m++) {
 					uchar grayValue = srcRow[x + m];
 					if (grayValue < minRow[x])
 						minRow[x] = grayValue;
-					else if (grayValue > maxRow[x])
+					if (grayValue > maxRow[x])
 						maxRow[x] = grayValue;
 				}
 			}
 		}
 	}
 }
+
+/*! Measure and print runtimes of naive and van Herk/Gil-Werman min/max filters.
+*
+* The runtimes are listed for increasing (square) kernel sizes. The van Herk/Gil-Werman
+* implementation is expected to be (almost) independent of the kernel size.
+*
+* \param image Source image to be filtered
+*/
+void benchmarkMinMaxFilters(const cv::Mat& image)
+{
+	const int KERNEL_SIZES[] = { 3, 5, 7, 11, 15, 21, 31, 51 };
+	cv::Mat minImage, maxImage;
+
+	cout << "Min/max filter runtimes for " << image.cols << "x" << image.rows << " image:" << endl;
+	cout << "Kernel\tNaive [ms]\tVan Herk [ms]" << endl;
+
+	for (int kernelSize : KERNEL_SIZES) {
+		int64 start = cv::getTickCount();
+		minMaxFilterNaive(image, minImage, maxImage, cv::Size(kernelSize, kernelSize));
+		double naiveMs = 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency();
+
+		start = cv::getTickCount();
+		minMaxFilter(image, minImage, maxImage, cv::Size(kernelSize, kernelSize));
+		double vanHerkMs = 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency();
+
+		cout << kernelSize << "x" << kernelSize << "\t" << naiveMs << "\t\t" << vanHerkMs << endl;
+	}
+}
@@ -0,0 +1,176 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Include files */
+#include <iostream>
+#include <cstdint>						// Declare uint16_t
+#include <vector>
+#include "Filter.h"
+
+/* Defines */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define IP_USE_SSE2 1
+#include <emmintrin.h>					// SSE2 intrinsics
+#endif
+
+#define MEDIAN_BINS 256					// Fine histogram bins (gray values)
+#define MEDIAN_COARSE_BINS 16			// Coarse histogram bins (upper 4 bits of gray values)
+#define MEDIAN_MAX_RADIUS 127			// Largest radius whose histogram counts fit into 16 bit
+
+/* Namespaces */
+using namespace std;
+
+namespace ip
+{
+	/*! Add a histogram to another one.
+	*
+	* \param dst [in,out] Histogram to add to
+	* \param src [in] Histogram to add
+	* \param bins [in] Number of bins (multiple of 8)
+	*/
+	static inline void addHistogram(uint16_t* dst, const uint16_t* src, int bins) {
+#ifdef IP_USE_SSE2
+		for (int i = 0; i < bins; i += 8) {
+			__m128i sum = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(dst + i)), _mm_loadu_si128((const __m128i*)(src + i)));
+			_mm_storeu_si128((__m128i*)(dst + i), sum);
+		}
+#else
+		for (int i = 0; i < bins; i++)
+			dst[i] += src[i];
+#endif
+	}
+
+	/*! Subtract a histogram from another one.
+	*
+	* \param dst [in,out] Histogram to subtract from
+	* \param src [in] Histogram to subtract
+	* \param bins [in] Number of bins (multiple of 8)
+	*/
+	static inline void subtractHistogram(uint16_t* dst, const uint16_t* src, int bins) {
+#ifdef IP_USE_SSE2
+		for (int i = 0; i < bins; i += 8) {
+			__m128i difference = _mm_sub_epi16(_mm_loadu_si128((const __m128i*)(dst + i)), _mm_loadu_si128((const __m128i*)(src + i)));
+			_mm_storeu_si128((__m128i*)(dst + i), difference);
+		}
+#else
+		for (int i = 0; i < bins; i++)
+			dst[i] -= src[i];
+#endif
+	}
+
+	/*! Apply median filter to 8-bit grayscale image in constant time per pixel.
+	*
+	* Reference: S. Perreault, P. Hebert: Median Filtering in Constant Time,
+	* IEEE Transactions on Image Processing 16(9), 2007.
+	*
+	* Each image column keeps a histogram of its 2r+1 pixels in the current kernel rows.
+	* Moving down one row removes one pixel from and adds one pixel to each column histogram.
+	* Moving right one pixel adds the entering and subtracts the leaving column histogram from
+	* the kernel histogram (SIMD). The costs are therefore independent of the kernel size.
+	*
+	* Both column and kernel histograms are two-level: A coarse histogram over the upper 4 bits
+	* locates the 16 fine bins containing the median, so at most 32 bins are searched per pixel.
+	*
+	* Border handling: Pixels outside the image are replaced by the closest border pixel (clamp),
+	* as in cv::medianBlur().
+	*
+	* \param image [in] Source image to be filtered (type CV_8U)
+	* \param filtered [out] Destination image
+	* \param kernelSize [in] Size K of the KxK filter kernel (odd, at most 255)
+	*/
+	void medianFilter(const cv::Mat& image, cv::Mat& filtered, int kernelSize) {
+		int r = kernelSize / 2;
+		int half = (kernelSize * kernelSize) / 2;
+
+		// Assert correct parameters
+		if (image.type() != CV_8U) {
+			cout << "[WARNING] Incorrect image type. CV_8U expected." << endl;
+			filtered = image.clone();
+			return;
+		}
+		if (((kernelSize % 2) == 0) || (r > MEDIAN_MAX_RADIUS)) {
+			cout << "[WARNING] Kernel size must be odd and not exceed " << 2 * MEDIAN_MAX_RADIUS + 1 << "." << endl;
+			filtered = image.clone();
+			return;
+		}
+
+		// Keep source intact when filtering in place
+		cv::Mat source = (image.data == filtered.data) ? image.clone() : image;
+		filtered.create(image.rows, image.cols, CV_8U);
+
+		int lastX = image.cols - 1, lastY = image.rows - 1;
+		vector<uint16_t> columnFine((size_t)image.cols * MEDIAN_BINS, 0);
+		vector<uint16_t> columnCoarse((size_t)image.cols * MEDIAN_COARSE_BINS, 0);
+		uint16_t kernelFine[MEDIAN_BINS], kernelCoarse[MEDIAN_COARSE_BINS];
+
+		// Init column histograms with rows -r .. r (clamped border)
+		for (int n = -r; n <= r; n++) {
+			const uchar* srcRow = source.ptr<uchar>(min(max(n, 0), lastY));
+
+			for (int x = 0; x < image.cols; x++) {
+				columnFine[(size_t)x * MEDIAN_BINS + srcRow[x]]++;
+				columnCoarse[(size_t)x * MEDIAN_COARSE_BINS + (srcRow[x] >> 4)]++;
+			}
+		}
+
+		// Run through image rows
+		for (int y = 0; y < image.rows; y++) {
+			uchar* dstRow = filtered.ptr<uchar>(y);
+
+			// Init kernel histogram with columns -r .. r (clamped border)
+			fill(kernelFine, kernelFine + MEDIAN_BINS, (uint16_t)0);
+			fill(kernelCoarse, kernelCoarse + MEDIAN_COARSE_BINS, (uint16_t)0);
+
+			for (int m = -r; m <= r; m++) {
+				size_t column = min(max(m, 0), lastX);
+
+				addHistogram(kernelFine, &columnFine[column * MEDIAN_BINS], MEDIAN_BINS);
+				addHistogram(kernelCoarse, &columnCoarse[column * MEDIAN_COARSE_BINS], MEDIAN_COARSE_BINS);
+			}
+
+			for (int x = 0; x < image.cols; x++) {
+				// Find coarse bin, then fine bin of the median (first value with cumulative count > half)
+				int count = 0, coarse = 0, value;
+
+				while (count + kernelCoarse[coarse] <= half)
+					count += kernelCoarse[coarse++];
+				for (value = coarse << 4; count + kernelFine[value] <= half; value++)
+					count += kernelFine[value];
+				dstRow[x] = (uchar)value;
+
+				// Move kernel histogram to next column
+				size_t entering = min(x + r + 1, lastX);
+				size_t leaving = max(x - r, 0);
+
+				if (entering != leaving) {
+					addHistogram(kernelFine, &columnFine[entering * MEDIAN_BINS], MEDIAN_BINS);
+					subtractHistogram(kernelFine, &columnFine[leaving * MEDIAN_BINS], MEDIAN_BINS);
+					addHistogram(kernelCoarse, &columnCoarse[entering * MEDIAN_COARSE_BINS], MEDIAN_COARSE_BINS);
+					subtractHistogram(kernelCoarse, &columnCoarse[leaving * MEDIAN_COARSE_BINS], MEDIAN_COARSE_BINS);
+				}
+			}
+
+			// Move column histograms to next row (remove row y - r, add row y + r + 1)
+			int leavingY = max(y - r, 0), enteringY = min(y + r + 1, lastY);
+
+			if ((y < lastY) && (leavingY != enteringY)) {
+				const uchar* leavingRow = source.ptr<uchar>(leavingY);
+				const uchar* enteringRow = source.ptr<uchar>(enteringY);
+
+				for (int x = 0; x < image.cols; x++) {
+					uint16_t* fine = &columnFine[(size_t)x * MEDIAN_BINS];
+					uint16_t* coarse = &columnCoarse[(size_t)x * MEDIAN_COARSE_BINS];
+
+					fine[leavingRow[x]]--;
+					fine[enteringRow[x]]++;
+					coarse[leavingRow[x] >> 4]--;
+					coarse[enteringRow[x] >> 4]++;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,20 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_FILTER_H
+#define IP_FILTER_H
+
+/* Include files */
+#include <opencv2/core/core.hpp>
+
+namespace ip
+{
+	void medianFilter(const cv::Mat& image, cv::Mat& filtered, int kernelSize);
+}
+
+#endif /* IP_FILTER_H */
@@ -11,6 +11,8 @@
 #include <iostream>
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
+#include "Clamp.h"
+#include "SimdKernels.h"
 
 /* Defines */
 #define IMAGE_DATA_PATH getenv("ImagingData")			// Read environment variable ImagingData
@@ -39,22 +41,18 @@ int main()
 	cv::Mat gradAbs, gradX, gradY, gradXAbs, gradYAbs;
 	gradient(image, gradAbs, gradX, gradY);
 
-	// Gradients x and y:
-	// Signed (CV_8S) to absolute (CV_8U, [-127, 127] -> [0, 127])
-	gradXAbs = cv::abs(gradX);
-	gradYAbs = cv::abs(gradY);
-	gradXAbs.convertTo(gradXAbs, CV_8U);
-	gradYAbs.convertTo(gradYAbs, CV_8U);
+	// Gradients x and y (absolute value, conversion and scaling in one pass each):
+	// Signed (CV_8S) to absolute (CV_8U, [-127, 127] -> [0, 127] -> [0, 254])
+	ip::convertClamp(gradX, gradXAbs, CV_8U, 2.0, 0.0, 0, 254, true);
+	ip::convertClamp(gradY, gradYAbs, CV_8U, 2.0, 0.0, 0, 254, true);
 
 	// Gradients x and y:
 	// Shift signed grad = 0 -> 127 ([-127, 127] -> [0, 254])
-	gradX.convertTo(gradX, CV_8U, 1, 127);
-	gradY.convertTo(gradY, CV_8U, 1, 127);
+	ip::convertClamp(gradX, gradX, CV_8U, 1.0, 127.0);
+	ip::convertClamp(gradY, gradY, CV_8U, 1.0, 127.0);
 
 	// Scale to use range
-	gradXAbs *= 2;								// [0, 127] -> [0, 254]
-	gradYAbs *= 2;
-	gradAbs *= 255.5 / (int)(sqrt(2) * 127);	// sqrt(2) * [0, 127] = [0, 179] -> [0, 255]
+	ip::convertClamp(gradAbs, gradAbs, CV_8U, 255.5 / (int)(sqrt(2) * 127));	// sqrt(2) * [0, 127] = [0, 179] -> [0, 255]
 
 	// Display images
 	cv::imshow("Image", image);
@@ -91,33 +89,23 @@ void gradient(const cv::Mat& image, cv::Mat& gradAbs, cv::Mat& gradX, cv::Mat& g
 	gradY = cv::Mat::zeros(cv::Size(image.cols, image.rows), CV_8S);
 	gradAbs = cv::Mat::zeros(cv::Size(image.cols, image.rows), CV_8U);
 
-	// Signed gradient in x
+	// Signed gradient in x (SSE2/AVX2 row kernels if available)
 	for (int y = 0; y < image.rows; y++) {
 		const uchar* srcRow = image.ptr<uchar>(y);
-		char* dstRow = gradX.ptr<char>(y);
+		schar* dstRow = gradX.ptr<schar>(y);
 
-		for (int x = 1; x < image.cols - 1; x++)
-			dstRow[x] = (char)(((int)srcRow[x + 1] - (int)srcRow[x - 1]) >> 1);
+		if (image.cols > 2)
+			ip::halfDifferenceRow(srcRow, srcRow + 2, dstRow + 1, image.cols - 2);
 	}
 
 	// Signed gradient in y
 	for (int y = 1; y < image.rows - 1; y++) {
-		const uchar* srcRows[2] = { image.ptr<uchar>(y - 1), image.ptr<uchar>(y + 1) };
-		char* dstRow = gradY.ptr<char>(y);
+		schar* dstRow = gradY.ptr<schar>(y);
 
-		for (int x = 0; x < image.cols; x++)
-			dstRow[x] = (char)((int)(srcRows[1][x] - (int)(srcRows[0][x])) >> 1);
+		ip::halfDifferenceRow(image.ptr<uchar>(y - 1), image.ptr<uchar>(y + 1), dstRow, image.cols);
 	}
 
 	// Absolute gradient
-	for (int y = 0; y < image.rows; y++) {
-		char* rowX = gradX.ptr<char>(y);
-		char* rowY = gradY.ptr<char>(y);
-		uchar* rowAbs = gradAbs.ptr<uchar>(y);
-
-		for (int x = 0; x < image.cols; x++) {
-			int gx = (int)rowX[x], gy = (int)rowY[x];
-			rowAbs[x] = (uchar)(cv::sqrt(gx * gx + gy * gy));
-		}
-	}
+	for (int y = 0; y < image.rows; y++)
+		ip::magnitudeRow(gradX.ptr<schar>(y), gradY.ptr<schar>(y), gradAbs.ptr<uchar>(y), image.cols);
 }
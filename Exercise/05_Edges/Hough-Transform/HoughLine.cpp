@@ -10,15 +10,24 @@
 
 /* Include files */
 #include "HoughLine.h"
+#include "Parallel.h"
+#include <algorithm>
 #include <cmath>
+#include <iostream>
+#include <queue>
+#include <vector>
 #include <opencv2/imgproc/imgproc.hpp>
 
 namespace ip {
 
 	/*! Calculate Hough transform for lines.
 	*
-	* \param edgeImage Source edge image (with edge pixels marked by value 255)
-	* \param houghImage Destination image to hold Hough transform of edge pixels
+	* The edge pixels are collected by SIMD compaction first (findEdgePixels()), so the voting
+	* runs through the edge pixels only. The counts are scaled to 8 bit (maximum 255) for display;
+	* the overload for edge lists returns the raw counts (e. g., for houghPeaks()).
+	*
+	* \param edgeImage Source edge image (with edge pixels marked by nonzero values, e. g., 255)
+	* \param houghSpace Destination image to hold Hough transform of edge pixels (CV_8U)
 	* \param height Target height of destination image (r axis)
 	* \param width Target width of destination image (theta axis, covering [0, pi])
 	*/
@@ -27,59 +36,250 @@ namespace ip {
 		if (edgeImage.type() != CV_8U)
 			return;
 
+		EdgeList edges;
+		findEdgePixels(edgeImage, edges);
+		houghTransform(edges, houghSpace, height, width);
+
+		// Convert to maximized 8-bit grayscale
+		double maxValue;
+		cv::minMaxLoc(houghSpace, NULL, &maxValue);
+		houghSpace.convertTo(houghSpace, CV_8U, 255.0 / std::max(maxValue, 1.0));
+	}
+
+	/*! Calculate Hough transform for lines from a list of edge pixels.
+	*
+	* The accumulator is stored theta-major with 32 bit counters: For one angle theta, all
+	* edge pixels vote into one column of radii, which stays in the L1 cache. Threads own
+	* disjoint ranges of angles, i. e., private parts of the accumulator, which are transposed
+	* into the (r, theta) Hough image at the end. The radius is calculated in 16.16 fixed
+	* point from LUTs already scaled to Hough image rows.
+	*
+	* With gradient directions in the edge list, the votes can be restricted to angles theta
+	* close to the direction: The gradient is normal to the line through the edge pixel, so
+	* only lines with theta around the gradient direction (modulo pi) are likely. Each edge
+	* pixel then votes for 2 * thetaTolerance / 180 * width + 1 angles instead of all. The
+	* directions are quantized to 1.4 degrees, and Sobel directions of sharp (aliased) edges
+	* deviate by up to about 10 degrees, so tolerances of 5 to 10 degrees are useful. The
+	* edge pixels are sorted by direction, so every angle runs through the matching
+	* directions only.
+	*
+	* \param edges Edge pixels (e. g., from sobelFilter() or findEdgePixels())
+	* \param houghSpace Destination image to hold Hough transform of edge pixels (counts in CV_32S)
+	* \param height Target height of destination image (r axis)
+	* \param width Target width of destination image (theta axis, covering [0, pi])
+	* \param thetaTolerance Vote for theta within +/- thetaTolerance degrees of the gradient
+	*        direction only (all angles for thetaTolerance >= 90 or without directions)
+	*/
+	void houghTransform(const EdgeList& edges, cv::Mat& houghSpace, int height, int width, double thetaTolerance) {
+		const int fractionBits = 16;		// Fixed point radius (16.16)
+
 		// Edge image geometry (source)
-		cv::Point imgCenter(edgeImage.cols / 2, edgeImage.rows / 2);
+		cv::Point imgCenter(edges.imageSize.width / 2, edges.imageSize.height / 2);
 
 		// Hough image geometry (destination)
 		double deltaTheta = M_PI / (double)width;
-		double deltaRadius = sqrt(edgeImage.cols * edgeImage.cols + edgeImage.rows * edgeImage.rows) / height;
+		double deltaRadius = sqrt(edges.imageSize.width * edges.imageSize.width + edges.imageSize.height * edges.imageSize.height) / height;
 		int v0 = height / 2;			// Draw r = 0 at vertical center
 
-		// Initialize accumulator image
-		houghSpace = cv::Mat::zeros(cv::Size(width, height), CV_16U);
-
-		// Pre-calc LUTs for speedup
-		double* cosLUT = new double[width];		// Throws exception on failure
-		double* sinLUT = new double[width];
+		// Pre-calc LUTs of cos(theta) / deltaRadius and sin(theta) / deltaRadius in fixed point.
+		// Truncation towards zero keeps |r| <= diagonal / 2, i. e., rows within [0, height].
+		// The row is v0 + (int)(r / deltaRadius + 0.5) as in the floating point version, i. e.,
+		// the rounded radius is truncated towards zero (a division, not a shift, which would
+		// round negative radii down and move their votes one row up).
+		std::vector<int> cosLUT(width), sinLUT(width);
 
 		for (int u = 0; u < width; u++) {
 			double theta = deltaTheta * u;
-			cosLUT[u] = cos(theta);
-			sinLUT[u] = sin(theta);
+			cosLUT[u] = (int)(cos(theta) / deltaRadius * (1 << fractionBits));
+			sinLUT[u] = (int)(sin(theta) / deltaRadius * (1 << fractionBits));
+		}
+		int rounding = 1 << (fractionBits - 1);
+
+		// Number of angles to vote for per edge pixel
+		int window = width;
+		bool isRestricted = edges.hasDirection() && (thetaTolerance < 90.0);
+
+		if (isRestricted)
+			window = std::min(2 * (int)ceil(thetaTolerance / 180.0 * width) + 1, width);
+
+		// Edge pixels relative to center, sorted by direction modulo pi (counting sort, one group
+		// of all pixels without restriction), and first angle of each group's window
+		int numGroups = isRestricted ? 128 : 1;
+		int numEdges = (int)edges.size();
+		std::vector<int> groupBegin(numGroups + 1, 0), groupUBegin(numGroups, 0);
+		std::vector<int> xc(numEdges), yc(numEdges);
+
+		if (isRestricted) {
+			for (int i = 0; i < numEdges; i++)
+				groupBegin[(edges.direction[i] & 127) + 1]++;
+			for (int d = 0; d < numGroups; d++) {
+				groupBegin[d + 1] += groupBegin[d];
+				groupUBegin[d] = (d * width + 64) / 128 - window / 2;
+			}
+		}
+		groupBegin[numGroups] = numEdges;
+
+		std::vector<int> next(groupBegin.begin(), groupBegin.end() - 1);
+
+		for (int i = 0; i < numEdges; i++) {
+			int j = isRestricted ? next[edges.direction[i] & 127]++ : i;
+
+			xc[j] = edges.x[i] - imgCenter.x;
+			yc[j] = edges.y[i] - imgCenter.y;
+		}
+
+		// Accumulator columns of height + 1 counters (with the rounding offset, the maximum
+		// radius r = diagonal / 2 reaches row height for any height, the last row catches it)
+		int stride = height + 1;
+		std::vector<int> accumulator((size_t)width * stride, 0);
+
+		// Run through angles theta (in parallel, each thread owns its accumulator columns)
+		parallelRows(width, 0, [&](const RowBand& band) {
+			for (int u = band.rowBegin; u < band.rowEnd; u++) {
+				int* column = accumulator.data() + (size_t)u * stride;
+				int* center = column + v0;
+				int cosTheta = cosLUT[u], sinTheta = sinLUT[u];
+
+				for (int d = 0; d < numGroups; d++) {
+					// Skip directions whose window does not contain theta (theta + pi is the same
+					// line with radius -r, so windows wrap around and vote with the negated radius)
+					if (isRestricted) {
+						int k = u - groupUBegin[d];
+						if (k < 0)
+							k += width;
+						else if (k >= width)
+							k -= width;
+						if (k >= window)
+							continue;
+					}
+
+					// Increment accumulator at radius (vertical position in Hough image)
+					for (int i = groupBegin[d]; i < groupBegin[d + 1]; i++)
+						center[(rounding + xc[i] * cosTheta + yc[i] * sinTheta) / (1 << fractionBits)]++;
+				}
+				column[height - 1] += column[height];
+			}
+		}, 8);
+
+		// Transpose accumulator to Hough image (rows in parallel)
+		houghSpace.create(height, width, CV_32S);
+
+		parallelRows(height, 0, [&](const RowBand& band) {
+			for (int v = band.rowBegin; v < band.rowEnd; v++) {
+				int* dstRow = houghSpace.ptr<int>(v);
+
+				for (int u = 0; u < width; u++)
+					dstRow[u] = accumulator[(size_t)u * stride + v];
+			}
+		});
+	}
+
+	/*! Find the strongest lines in the Hough space by non-maximum suppression.
+	*
+	* A bin is a peak if it is the maximum of its (theta, r) neighborhood (ties go to the bin
+	* first in row order). Neighbors beyond theta = 0 or pi wrap around with the mirrored
+	* radius, as theta + pi is the same line with radius -r. The raw accumulator is scanned
+	* once: Bands of rows keep their strongest peaks in bounded min-heaps (one per thread),
+	* so the neighborhood is compared only for bins stronger than the weakest peak kept, and
+	* the heaps are merged at the end.
+	*
+	* \param houghSpace Hough space (raw counts in CV_32S, see houghTransform())
+	* \param imgSize Edge image size (for the line parameters)
+	* \param peaks [out] Peaks sorted by votes (descending), at most maxPeaks
+	* \param maxPeaks Maximum number of peaks
+	* \param neighborhood Size of the suppression neighborhood (theta bins x r bins, odd)
+	* \param minVotes Minimum number of votes of a peak
+	*/
+	void houghPeaks(const cv::Mat& houghSpace, cv::Size imgSize, std::vector<houghPeak>& peaks, int maxPeaks, cv::Size neighborhood, int minVotes) {
+		peaks.clear();
+
+		// Check image type
+		if (houghSpace.type() != CV_32S) {
+			std::cout << "[WARNING] Incorrect Hough space type. CV_32S expected." << std::endl;
+			return;
 		}
+		if (maxPeaks <= 0)
+			return;
+
+		// Hough image geometry (neighbors wrapping around theta must not reach the bin itself)
+		int width = houghSpace.cols, height = houghSpace.rows;
+		int radiusU = std::min(neighborhood.width / 2, (width - 1) / 2), radiusV = neighborhood.height / 2;
+		int v0 = height / 2;			// r = 0 at vertical center
+
+		// Peak candidates (votes, index in row order), top of a heap is the weakest peak
+		typedef std::pair<int, int> Candidate;
+		auto isStronger = [](const Candidate& a, const Candidate& b) {
+			return (a.first > b.first) || ((a.first == b.first) && (a.second < b.second));
+		};
+		typedef std::priority_queue<Candidate, std::vector<Candidate>, decltype(isStronger)> CandidateHeap;
+		std::vector<CandidateHeap> heaps(getNumThreads(), CandidateHeap(isStronger));
 
-		// Run through edge image
-		for (int y = 0; y < edgeImage.rows; y++) {
-			const uchar* row = edgeImage.ptr<uchar>(y);
-
-			for (int x = 0; x < edgeImage.cols; x++) {
-				// Edge pixel found
-				if (row[x] == 255) {
-					// Source location relative to center
-					int xc = x - imgCenter.x;
-					int yc = y - imgCenter.y;
-
-					// Run through angles theta
-					for (int u = 0; u < width; u++) {
-						// Radius (vertical position in Hough image)
-						double r = xc * cosLUT[u] + yc * sinLUT[u];
-						int v = v0 + (int)(r / deltaRadius + 0.5);
-
-						// Increment accumulator
-						houghSpace.at<ushort>(v, u)++;
+		// Check whether a bin is the maximum of its neighborhood
+		auto isMaximum = [&](int v, int u, const Candidate& candidate) {
+			for (int dv = -radiusV; dv <= radiusV; dv++) {
+				for (int du = -radiusU; du <= radiusU; du++) {
+					int nu = u + du, nv = v + dv;
+
+					if (nu < 0) {
+						nu += width;
+						nv = 2 * v0 - nv;
+					}
+					else if (nu >= width) {
+						nu -= width;
+						nv = 2 * v0 - nv;
 					}
+					if ((nv < 0) || (nv >= height) || ((du == 0) && (dv == 0)))
+						continue;
+
+					if (isStronger(Candidate(houghSpace.ptr<int>(nv)[nu], nv * width + nu), candidate))
+						return false;
+				}
+			}
+			return true;
+		};
+
+		// Scan bands of rows (in parallel)
+		parallelRows(height, 0, [&](const RowBand& band) {
+			CandidateHeap& heap = heaps[getThreadIndex()];
+
+			for (int v = band.rowBegin; v < band.rowEnd; v++) {
+				const int* row = houghSpace.ptr<int>(v);
+
+				for (int u = 0; u < width; u++) {
+					Candidate candidate(row[u], v * width + u);
+
+					if ((row[u] < minVotes) || (((int)heap.size() == maxPeaks) && !isStronger(candidate, heap.top())))
+						continue;
+					if (!isMaximum(v, u, candidate))
+						continue;
+
+					heap.push(candidate);
+					if ((int)heap.size() > maxPeaks)
+						heap.pop();
 				}
 			}
+		});
+
+		// Merge heaps, keep strongest peaks
+		std::vector<Candidate> candidates;
+
+		for (CandidateHeap& heap : heaps) {
+			for (; !heap.empty(); heap.pop())
+				candidates.push_back(heap.top());
 		}
+		std::sort(candidates.begin(), candidates.end(), isStronger);
+		if ((int)candidates.size() > maxPeaks)
+			candidates.resize(maxPeaks);
 
-		// Convert to maximized 8-bit grayscale
-		double maxValue;
-		cv::minMaxLoc(houghSpace, NULL, &maxValue);
-		houghSpace.convertTo(houghSpace, CV_8U, 255.0 / maxValue);
+		// Line parameters of peaks
+		for (const Candidate& candidate : candidates) {
+			houghPeak peak;
 
-		// Free LUT memory
-		delete[] cosLUT;
-		delete[] sinLUT;
+			peak.location = cv::Point(candidate.second % width, candidate.second / width);
+			peak.votes = candidate.first;
+			houghSpaceToLine(imgSize, houghSpace.size(), peak.location.x, peak.location.y, peak.r, peak.theta);
+			peaks.push_back(peak);
+		}
 	}
 
 	/*! Calculate parameters of line corresponding to a specific point in the Hough space.
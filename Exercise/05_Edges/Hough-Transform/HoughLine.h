@@ -10,12 +10,24 @@
 #define IP_HOUGH_LINE_H
 
 /* Include files */
+#include <vector>
 #include <opencv2/core/core.hpp>
+#include "EdgeList.h"
 
 namespace ip
 {
+	/* Datatypes */
+	/*! Peak of the Hough space, i. e., a line (see houghPeaks()). */
+	struct houghPeak {
+		cv::Point location;				// Position in Hough space (x: theta, y: r)
+		int votes = 0;					// Accumulator count
+		double r = 0.0, theta = 0.0;	// Line parameters (see houghSpaceToLine())
+	};
+
 	/* Prototypes */
 	void houghTransform(const cv::Mat& edgeImage, cv::Mat& houghSpace, int height = 361, int width = 360);
+	void houghTransform(const EdgeList& edges, cv::Mat& houghSpace, int height = 361, int width = 360, double thetaTolerance = 90.0);
+	void houghPeaks(const cv::Mat& houghSpace, cv::Size imgSize, std::vector<houghPeak>& peaks, int maxPeaks = 10, cv::Size neighborhood = cv::Size(15, 15), int minVotes = 1);
 	void houghSpaceToLine(cv::Size imgSize, cv::Size houghSize, int x, int y, double& r, double& theta);
 	void drawLine(cv::Mat& image, double r, double theta);
 	void drawHoughLineLabels(cv::Mat& houghSpace);
@@ -8,6 +8,7 @@
 #define _CRT_SECURE_NO_WARNINGS		// Enable getenv()
 
 /* Include files */
+#include <algorithm>
 #include <iostream>
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
@@ -19,7 +20,9 @@
 #define IMAGE_DATA_PATH getenv("ImagingData")			// Read environment variable ImagingData
 #define INPUT_IMAGE_RELATIVE_PATH "/Images/Docks.jpg"	// Image file including relative path
 #define EDGE_IMAGE_THRESHOLD 25
-#define SMOOTHING_KERNEL_SIZE 1
+#define HOUGH_THETA_TOLERANCE 10.0		// Vote for angles within +/- 10 of the gradient direction
+#define HOUGH_NUM_LINES 10				// Number of strongest lines to draw
+#define HOUGH_PEAK_NEIGHBORHOOD 15		// Non-maximum suppression in 15 x 15 bins of (theta, r)
 #define IS_WRITE_IMAGES false
 
 /* Namespaces */
@@ -38,32 +41,32 @@ int main()
 		return 0;
 	}
 
-	// Calculate edge image
-	cv::Mat edgeImage;
-	sobelFilter(image, edgeImage);
-	cv::threshold(edgeImage, edgeImage, EDGE_IMAGE_THRESHOLD, 255, cv::THRESH_BINARY);
+	// Calculate edge image and list of edge pixels (Sobel and threshold in a single pass)
+	cv::Mat sobelImage, edgeImage;
+	EdgeList edges;
+	sobelFilter(image, sobelImage, SOBEL_L2, NULL, &edgeImage, EDGE_IMAGE_THRESHOLD, &edges);
 
-	// Calculate Hough transform
+	// Calculate Hough transform (of the edge pixels only)
 	cv::Mat houghSpace;
-	houghTransform(edgeImage, houghSpace);
+	houghTransform(edges, houghSpace, 361, 360, HOUGH_THETA_TOLERANCE);
 
-	// Find global maximum in Hough space ...
-	cv::Point houghMaxLocation;
-	cv::GaussianBlur(houghSpace, houghSpace, cv::Size(SMOOTHING_KERNEL_SIZE, SMOOTHING_KERNEL_SIZE), 0.0);
-	cv::minMaxLoc(houghSpace, NULL, NULL, NULL, &houghMaxLocation);
+	// Find strongest lines in Hough space (non-maximum suppression) ...
+	vector<houghPeak> peaks;
+	houghPeaks(houghSpace, cv::Size(edgeImage.cols, edgeImage.rows), peaks, HOUGH_NUM_LINES,
+		cv::Size(HOUGH_PEAK_NEIGHBORHOOD, HOUGH_PEAK_NEIGHBORHOOD));
 
-	// ... and draw corresponding line in original image
-	double r, theta;
-	houghSpaceToLine(
-		cv::Size(edgeImage.cols, edgeImage.rows),
-		cv::Size(houghSpace.cols, houghSpace.rows),
-		houghMaxLocation.x, houghMaxLocation.y, r, theta);
-	drawLine(image, r, theta);
+	// ... and draw corresponding lines in original image
+	for (const houghPeak& peak : peaks)
+		drawLine(image, peak.r, peak.theta);
 
 	// Prepare Hough space image for display
+	double houghMaxValue;
+	cv::minMaxLoc(houghSpace, NULL, &houghMaxValue);
+	houghSpace.convertTo(houghSpace, CV_8U, 255.0 / max(houghMaxValue, 1.0));	// Scale to 8 bit
 	houghSpace = 255 - houghSpace;											// Invert
 	drawHoughLineLabels(houghSpace);										// Axes
-	cv::circle(houghSpace, houghMaxLocation, 10, cv::Scalar(0, 0, 255), 2);	// Global maximum
+	for (const houghPeak& peak : peaks)
+		cv::circle(houghSpace, peak.location, 10, cv::Scalar(0, 0, 255), 2);	// Peaks
 
 	// Display image in named window
 	cv::imshow("Image", image);
@@ -5,40 +5,230 @@
 */
 
 
+/* Compiler settings */
+#define _USE_MATH_DEFINES
+
 /* Include files */
 #include "Sobel.h"
-#include <opencv2/imgproc/imgproc.hpp>
+#include "Parallel.h"
+#include "SimdKernels.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/* Defines */
+#define SOBEL_MAX_SQUARED (2 * 1020 * 1020)		// Maximum gx^2 + gy^2 of 8-bit images
 
 namespace ip {
-	/*! Calculate Sobel edge image(s).
+	/*! Lookup table of the L2 magnitude sqrt(gx^2 + gy^2) / 8.
+	*
+	* Indexed by (gx^2 + gy^2) / 64. As floor(sqrt(s / 64)) = floor(sqrt(floor(s / 64))),
+	* the lookup is exact despite the reduced index.
 	*
-	* \param image Source image to calculate Sobel edge images for
-	* \param sobel Absolute Sobel image sqrt(Sobel(x)^2 + Sobel(y)^2) in [0, sqrt(2) * 127]
+	* \return table of SOBEL_MAX_SQUARED / 64 + 1 entries
 	*/
-	void sobelFilter(const cv::Mat& image, cv::Mat& sobel) {
-		// Filter kernels
-		cv::Mat kernelGradient = (cv::Mat_<double>(1, 3) << -1, 0, 1) / 2.0;
-		cv::Mat kernelBinomial = (cv::Mat_<double>(1, 3) << 1, 2, 1) / 4.0;
-
-		// Signed sobel edge images in x and y
-		cv::Mat image16S, sobelX, sobelY;
-		image.convertTo(image16S, CV_16S, 128);	// sepFilter2D does not support CV_8U -> CV_16S
-		cv::sepFilter2D(image16S, sobelX, CV_16S, kernelGradient, kernelBinomial);
-		cv::sepFilter2D(image16S, sobelY, CV_16S, kernelBinomial, kernelGradient);
-
-		// Calculate absolute Sobel edge image
-		sobel = image.clone();
-		for (int y = 0; y < image.rows; y++) {
-			short* rowX = sobelX.ptr<short>(y);
-			short* rowY = sobelY.ptr<short>(y);
-			uchar* rowAbs = sobel.ptr<uchar>(y);
-
-			for (int x = 0; x < image.cols; x++) {
-				int gx = (int)rowX[x];
-				int gy = (int)rowY[x];
-
-				rowAbs[x] = (uchar)(cv::sqrt(gx * gx + gy * gy) / 128.0);	// CV_16S -> CV_8U
+	static const uchar* magnitudeLut() {
+		static const std::vector<uchar> lut = [] {
+			std::vector<uchar> table(SOBEL_MAX_SQUARED / 64 + 1);
+
+			for (int i = 0, m = 0; i < (int)table.size(); i++) {
+				while ((m + 1) * (m + 1) <= i)
+					m++;
+				table[i] = (uchar)m;
 			}
+			return table;
+		}();
+
+		return lut.data();
+	}
+
+	/*! Lookup table of atan(k / 128) for k = 0 .. 128 in units of 1 / 65536 turn.
+	*
+	* \return table of 129 entries
+	*/
+	static const int* atanLut() {
+		static const std::vector<int> lut = [] {
+			std::vector<int> table(129);
+
+			for (int k = 0; k <= 128; k++)
+				table[k] = (int)(atan(k / 128.0) / (2.0 * M_PI) * 65536.0 + 0.5);
+			return table;
+		}();
+
+		return lut.data();
+	}
+
+	/*! Quantized gradient direction atan2(gy, gx).
+	*
+	* The angle is reduced to the first octant, looked up there, and mirrored back.
+	*
+	* \param gx Gradient in x
+	* \param gy Gradient in y
+	* \param lut Table of atanLut()
+	* \return direction in 1 / 256 turn (0 for gx = gy = 0)
+	*/
+	static inline uchar quantizedDirection(int gx, int gy, const int* lut) {
+		int ax = abs(gx), ay = abs(gy);
+		int minAbs = std::min(ax, ay), maxAbs = std::max(ax, ay);
+
+		if (maxAbs == 0)
+			return 0;
+
+		int angle = lut[(minAbs * 128 + maxAbs / 2) / maxAbs];		// [0, 1/8] turn
+		if (ay > ax)
+			angle = 16384 - angle;
+		if (gx < 0)
+			angle = 32768 - angle;
+		if (gy < 0)
+			angle = 65536 - angle;
+		return (uchar)((angle + 128) >> 8);
+	}
+
+	/*! Calculate Sobel edge images in a single pass.
+	*
+	* Gradients gx, gy are calculated by the integer Sobel kernels [-1 0 1] x [1 2 1]^T and
+	* [1 2 1] x [-1 0 1]^T. The rows of a band are read once, the vertical sums of the 3 rows
+	* are kept in a row buffer, and all outputs are derived from the row buffer while it is
+	* in cache. Pixels outside the image are mirrored (without repeating the border pixel, as
+	* the default of OpenCV filters).
+	*
+	* The magnitudes are scaled by 1/8 and truncated, i. e., the L2 result is identical to
+	* the former floating point implementation (sepFilter2D() and sqrt()).
+	*
+	* \param image Source image (CV_8U) to calculate Sobel edge images for
+	* \param sobel Gradient magnitude image (CV_8U), see SobelNorm for the range
+	* \param norm Norm of the gradient magnitude
+	* \param direction Optional gradient direction image (CV_8U) in 1/256 turn, i. e., 256 steps
+	*        of 1.40625 degrees. 0 points right, 64 down (image coordinates). NULL to skip.
+	* \param edgeImage Optional binary edge image (CV_8U), 255 if magnitude > threshold, 0 otherwise.
+	*        NULL to skip.
+	* \param threshold Threshold of the binary edge image
+	* \param edgeList Optional list of the edge pixels (magnitude > threshold) with their
+	*        directions, e. g., for the Hough transform. Directions are calculated for the edge
+	*        pixels only. NULL to skip.
+	*/
+	void sobelFilter(const cv::Mat& image, cv::Mat& sobel, SobelNorm norm, cv::Mat* direction, cv::Mat* edgeImage, uchar threshold, EdgeList* edgeList) {
+		// Assert correct parameters
+		if (image.type() != CV_8U) {
+			std::cout << "[WARNING] Incorrect image type. CV_8U expected." << std::endl;
+			return;
 		}
+
+		// Keep source intact when filtering in place
+		bool isInPlace = (image.data == sobel.data) || (direction && (image.data == direction->data)) || (edgeImage && (image.data == edgeImage->data));
+		cv::Mat source = isInPlace ? image.clone() : image;
+		int cols = source.cols, rows = source.rows;
+
+		sobel.create(rows, cols, CV_8U);
+		if (direction)
+			direction->create(rows, cols, CV_8U);
+		if (edgeImage)
+			edgeImage->create(rows, cols, CV_8U);
+
+		if (edgeList) {
+			edgeList->clear();
+			edgeList->imageSize = source.size();
+		}
+
+		const uchar* magnitudes = magnitudeLut();
+		const int* atans = atanLut();
+		std::map<int, EdgeList> bandLists;		// Edge lists of bands (sorted by first row)
+		std::mutex bandMutex;
+
+		parallelRows(rows, 1, [&](const RowBand& band) {
+			// Vertical sums [1 2 1]^T and differences [-1 0 1]^T, padded by one column on each side
+			std::vector<short> paddedSums(cols + 2), paddedDiffs(cols + 2);
+			short* colSums = paddedSums.data() + 1;
+			short* colDiffs = paddedDiffs.data() + 1;
+
+			// Edge row (if no edge image is requested) and edge columns for the edge list
+			std::vector<uchar> edgeBuffer(edgeList && !edgeImage ? cols : 0);
+			std::vector<int> columns(edgeList ? cols : 0);
+			EdgeList bandEdges;
+
+			for (int y = band.rowBegin; y < band.rowEnd; y++) {
+				// Rows above and below (mirrored at the border)
+				int yAbove = (y > 0) ? y - 1 : std::min(1, rows - 1);
+				int yBelow = (y < rows - 1) ? y + 1 : std::max(rows - 2, 0);
+				const uchar* above = source.ptr<uchar>(yAbove);
+				const uchar* center = source.ptr<uchar>(y);
+				const uchar* below = source.ptr<uchar>(yBelow);
+
+				for (int x = 0; x < cols; x++) {
+					colSums[x] = (short)(above[x] + 2 * center[x] + below[x]);
+					colDiffs[x] = (short)(below[x] - above[x]);
+				}
+
+				// Mirror columns
+				colSums[-1] = colSums[std::min(1, cols - 1)];
+				colDiffs[-1] = colDiffs[std::min(1, cols - 1)];
+				colSums[cols] = colSums[std::max(cols - 2, 0)];
+				colDiffs[cols] = colDiffs[std::max(cols - 2, 0)];
+
+				// Magnitude
+				uchar* sobelRow = sobel.ptr<uchar>(y);
+
+				if (norm == SOBEL_L1) {
+					for (int x = 0; x < cols; x++) {
+						int gx = colSums[x + 1] - colSums[x - 1];
+						int gy = colDiffs[x - 1] + 2 * colDiffs[x] + colDiffs[x + 1];
+						sobelRow[x] = (uchar)((abs(gx) + abs(gy)) >> 3);
+					}
+				}
+				else {
+					for (int x = 0; x < cols; x++) {
+						int gx = colSums[x + 1] - colSums[x - 1];
+						int gy = colDiffs[x - 1] + 2 * colDiffs[x] + colDiffs[x + 1];
+						sobelRow[x] = magnitudes[(gx * gx + gy * gy) >> 6];
+					}
+				}
+
+				// Binary edge image
+				if (edgeImage || edgeList) {
+					uchar* edgeRow = edgeImage ? edgeImage->ptr<uchar>(y) : edgeBuffer.data();
+
+					for (int x = 0; x < cols; x++)
+						edgeRow[x] = (sobelRow[x] > threshold) ? 255 : 0;
+
+					// Edge pixels with directions
+					if (edgeList) {
+						int count = nonZeroColumns(edgeRow, cols, columns.data());
+
+						for (int i = 0; i < count; i++) {
+							int x = columns[i];
+							int gx = colSums[x + 1] - colSums[x - 1];
+							int gy = colDiffs[x - 1] + 2 * colDiffs[x] + colDiffs[x + 1];
+
+							bandEdges.x.push_back(x);
+							bandEdges.y.push_back(y);
+							bandEdges.direction.push_back(quantizedDirection(gx, gy, atans));
+						}
+					}
+				}
+
+				// Direction
+				if (direction) {
+					uchar* directionRow = direction->ptr<uchar>(y);
+
+					for (int x = 0; x < cols; x++) {
+						int gx = colSums[x + 1] - colSums[x - 1];
+						int gy = colDiffs[x - 1] + 2 * colDiffs[x] + colDiffs[x + 1];
+						directionRow[x] = quantizedDirection(gx, gy, atans);
+					}
+				}
+			}
+
+			if (edgeList) {
+				std::lock_guard<std::mutex> lock(bandMutex);
+				bandLists[band.rowBegin] = std::move(bandEdges);
+			}
+		});
+
+		// Append edge lists of bands in row order
+		for (const auto& bandList : bandLists)
+			edgeList->append(bandList.second);
 	}
 }
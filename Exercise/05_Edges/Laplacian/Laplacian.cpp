@@ -12,6 +12,7 @@
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc.hpp>
+#include "Clamp.h"
 
 /* Defines */
 #define IMAGE_DATA_PATH getenv("ImagingData")			// Read environment variable ImagingData
@@ -40,15 +41,15 @@ int main()
 	cv::Mat kernelL8 = (cv::Mat_<double>(3, 3) << 1, 1, 1, 1, -8, 1, 1, 1, 1);
 	cv::Mat kernelL12 = (cv::Mat_<double>(3, 3) << 1, 2, 1, 2, -12, 2, 1, 2, 1);
 
-	image.convertTo(image16S, CV_16S, 128);		// CV_8U -> CV_16S
+	ip::convertClamp(image, image16S, CV_16S, 128);		// CV_8U -> CV_16S
 	cv::filter2D(image16S, laplace4, CV_16S, kernelL4);
 	cv::filter2D(image16S, laplace8, CV_16S, kernelL8);
 	cv::filter2D(image16S, laplace12, CV_16S, kernelL12);
 
-	// Convert CV_16S -> CV_8U
-	laplace4.convertTo(laplace4, CV_8U, 1.0 / 128, 127);
-	laplace8.convertTo(laplace8, CV_8U, 1.0 / 128, 127);
-	laplace12.convertTo(laplace12, CV_8U, 1.0 / 128, 127);
+	// Convert CV_16S -> CV_8U (scaling, shift and saturation in one pass)
+	ip::convertClamp(laplace4, laplace4, CV_8U, 1.0 / 128, 127);
+	ip::convertClamp(laplace8, laplace8, CV_8U, 1.0 / 128, 127);
+	ip::convertClamp(laplace12, laplace12, CV_8U, 1.0 / 128, 127);
 
 	// Display images
 	cv::imshow("Image", image);
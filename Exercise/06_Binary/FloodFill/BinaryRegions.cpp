@@ -11,6 +11,7 @@
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include "BinaryRegions.h"
+#include "Parallel.h"
 
 /* Namespaces */
 using namespace std;
@@ -111,17 +112,20 @@ namespace ip
 		}
 		cv::cvtColor(colors, colors, cv::COLOR_HSV2BGR);
 
-		// Create colored copy
+		// Create colored copy (horizontal bands in parallel)
+		const cv::Vec3b* palette = colors.ptr<cv::Vec3b>(0);
 		rgbImage = cv::Mat(cv::Size(labelImage.cols, labelImage.rows), CV_8UC3);
 
-		for (int y = 0; y < labelImage.rows; y++) {
-			const uchar* srcRow = labelImage.ptr<uchar>(y);
-			cv::Vec3b* dstRow = rgbImage.ptr<cv::Vec3b>(y);
+		parallelRows(labelImage.rows, 0, [&](const RowBand& band) {
+			for (int y = band.rowBegin; y < band.rowEnd; y++) {
+				const uchar* srcRow = labelImage.ptr<uchar>(y);
+				cv::Vec3b* dstRow = rgbImage.ptr<cv::Vec3b>(y);
 
-			for (int x = 0; x < labelImage.cols; x++) {
-				dstRow[x] = colors.at<cv::Vec3b>(srcRow[x]);
+				for (int x = 0; x < labelImage.cols; x++) {
+					dstRow[x] = palette[srcRow[x]];
+				}
 			}
-		}
+		});
 	}
 
 	/*! Determine BLOB features for labeled regions.
@@ -7,6 +7,7 @@
 
 /* Include files */
 #include "Histogram.h"
+#include "HistogramKernel.h"
 #include <iostream>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
@@ -34,34 +35,62 @@ namespace ip
 
 	/*! Calculate the histogram data for 8-bit grayscale images.
 	*
+	* Rows are counted in parallel into interleaved sub-histograms (see countHistogram()).
+	*
 	* \param image Image to calculate histogram for (8-bit grayscale)
 	* \param histogram Array to store histogram data in
+	* \param cumulative Array to store cumulative histogram data in (optional)
 	*/
 	void calcHistogram(const cv::Mat& image, unsigned histogram[256], unsigned cumulative[256]) {
-		const int NUMBER_BINS = 256;
+		// Check for correct image type (8-bit grayscale)
+		if (image.type() != CV_8U)
+			return;
+
+		countHistogram(image, histogram, cumulative);
+	}
 
+	/*! Calculate a sampled (and smoothed) histogram for 8-bit grayscale images.
+	*
+	* Intended for statistics of live camera frames, which do not need exact counts:
+	* Only every stride-th pixel of every stride-th row inside the mask is counted, and the
+	* result can be smoothed with the previous frame's histogram to keep derived thresholds stable.
+	*
+	* \param image Image to calculate histogram for (8-bit grayscale)
+	* \param histogram Array to store histogram data in
+	* \param stride Sampling stride in x and y (1: all pixels, 4: 1/16 of the pixels)
+	* \param mask Pixels to count (mask value not 0) or empty for all pixels
+	* \param previous Histogram of the previous frame for exponential smoothing (optional)
+	* \param weight Weight of the current frame for smoothing in [0.0, 1.0]
+	*/
+	void calcHistogram(const cv::Mat& image, unsigned histogram[256], int stride, const cv::Mat& mask, const unsigned previous[256], double weight) {
 		// Check for correct image type (8-bit grayscale)
 		if (image.type() != CV_8U)
 			return;
 
-		// Init array
-		for (int i = 0; i < NUMBER_BINS; i++)
-			histogram[i] = 0;
+		countHistogram(image, histogram, stride, mask);
 
-		// Count pixel values
-		for (int y = 0; y < image.rows; y++) {
-			const uchar* data = image.ptr<uchar>(y);
-			for (int x = 0; x < image.cols; x++) {
-				histogram[data[x]]++;
-			}
-		}
+		if (previous != NULL)
+			smoothHistogram(histogram, previous, weight);
+	}
 
-		// Cumulative histogram
-		if (cumulative != NULL) {
-			cumulative[0] = histogram[0];
-			for (int i = 1; i < NUMBER_BINS; i++)
-				cumulative[i] = cumulative[i - 1] + histogram[i];
-		}
+	/*! Calculate a sampled (and smoothed) histogram of regions of interest for 8-bit grayscale images.
+	*
+	* \param image Image to calculate histogram for (8-bit grayscale)
+	* \param histogram Array to store histogram data in
+	* \param stride Sampling stride in x and y (1: all pixels, 4: 1/16 of the pixels)
+	* \param rois Regions of interest (clipped to the image)
+	* \param previous Histogram of the previous frame for exponential smoothing (optional)
+	* \param weight Weight of the current frame for smoothing in [0.0, 1.0]
+	*/
+	void calcHistogram(const cv::Mat& image, unsigned histogram[256], int stride, const vector<cv::Rect>& rois, const unsigned previous[256], double weight) {
+		// Check for correct image type (8-bit grayscale)
+		if (image.type() != CV_8U)
+			return;
+
+		countHistogram(image, histogram, stride, rois);
+
+		if (previous != NULL)
+			smoothHistogram(histogram, previous, weight);
 	}
 
 	/*! Create image depicting the histogram and cumulative histogram of a 8-bit grayscale image.
@@ -82,11 +111,7 @@ namespace ip
 		// Init array and count pixels
 		unsigned hist[NUMBER_BINS] = { 0 };
 		unsigned cumHist[NUMBER_BINS] = { 0 };
-		calcHistogram(image, hist);
-
-		cumHist[0] = hist[0];
-		for (int i = 1; i < NUMBER_BINS; i++)
-			cumHist[i] = cumHist[i - 1] + hist[i];
+		calcHistogram(image, hist, cumHist);
 
 		// Find maximum histogram value
 		unsigned maxCount = max(hist, NUMBER_BINS);
@@ -10,6 +10,7 @@
 #define IP_HISTOGRAM_H
 
 /* Include files */
+#include <vector>
 #include <opencv2/core/core.hpp>
 
 namespace ip
@@ -17,6 +18,8 @@ namespace ip
 	/* Prototypes */
 	unsigned max(unsigned values[], int size);
 	void calcHistogram(const cv::Mat& image, unsigned histogram[256], unsigned cumulative[256] = NULL);
+	void calcHistogram(const cv::Mat& image, unsigned histogram[256], int stride, const cv::Mat& mask = cv::Mat(), const unsigned previous[256] = NULL, double weight = 0.25);
+	void calcHistogram(const cv::Mat& image, unsigned histogram[256], int stride, const std::vector<cv::Rect>& rois, const unsigned previous[256] = NULL, double weight = 0.25);
 	void createHistogramImage(const cv::Mat& image, cv::Mat& histogram, bool isCumulative = true);
 	void addLineToHistogramImage(cv::Mat& histogram, uchar level, cv::Scalar color = cv::Scalar(255, 0, 0));
 }
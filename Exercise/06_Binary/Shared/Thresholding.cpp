@@ -6,11 +6,14 @@
 
 
 /* Include files */
+#include <cstdint>						// Declare uint64_t
 #include <iostream>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include "Thresholding.h"
 #include "Histogram.h"
+#include "HistogramKernel.h"
+#include "Parallel.h"
 
 /* Namespaces */
 using namespace std;
@@ -42,17 +45,72 @@ namespace ip
 	* \param calculatedThresh [out] Threshold calculated and applied to image
 	*/
 	void isodataThreshold(const cv::Mat& image, cv::Mat& binImage, uchar* calculatedThresh) {
+		unsigned histogram[256];
+
+		// Calculate histogram and threshold
+		calcHistogram(image, histogram);
+		uchar thresh = calcIsodataThreshold(histogram);
+
+		// Apply threshold
+		cv::threshold(image, binImage, thresh, 255, cv::THRESH_BINARY);
+
+		// Return calculated threshold
+		if (calculatedThresh != NULL)
+			*calculatedThresh = thresh;
+	}
+
+	/*! Apply globally adaptive threshold using the isodata algorithm on a sampled, smoothed histogram.
+	*
+	* Real-time variant for camera frames: The threshold is calculated from every stride-th pixel
+	* of every stride-th row, and the histogram is smoothed with the previous frame's histogram,
+	* which keeps the threshold stable from frame to frame.
+	*
+	* \param image [in] Input image g(x,y) to apply threshold to (type CV_8U)
+	* \param binImage [out] Resulting binary image with values in {0, 255}
+	* \param stride [in] Sampling stride in x and y (4: 1/16 of the pixels)
+	* \param histogram [in,out] Smoothed histogram of the previous frame (all 0 for the first frame), updated
+	* \param calculatedThresh [out] Threshold calculated and applied to image
+	*/
+	void isodataThreshold(const cv::Mat& image, cv::Mat& binImage, int stride, unsigned histogram[256], uchar* calculatedThresh) {
+		unsigned current[256];
+
+		// Calculate sampled histogram smoothed with the previous one
+		calcHistogram(image, current, stride, cv::Mat(), histogram);
+		for (int g = 0; g < 256; g++)
+			histogram[g] = current[g];
+
+		uchar thresh = calcIsodataThreshold(histogram);
+
+		// Apply threshold
+		cv::threshold(image, binImage, thresh, 255, cv::THRESH_BINARY);
+
+		// Return calculated threshold
+		if (calculatedThresh != NULL)
+			*calculatedThresh = thresh;
+	}
+
+	/*! Calculate threshold using the isodata algorithm from a histogram.
+	*
+	* The histogram may be based on all or on a sample of the pixels.
+	*
+	* \param histogram [in] Histogram of the image
+	* \return threshold (center of background mean and foreground mean)
+	*/
+	uchar calcIsodataThreshold(const unsigned histogram[256]) {
 		uchar thresh = 0, lastThresh = -1;
-		unsigned numberPixels = image.cols * image.rows;
-		unsigned histogram[256], cumulative[256], pixelSums[256];
+		unsigned cumulative[256];
+		uint64_t pixelSums[256];
 
-		// Calculate histogram and cumulative histogram
-		calcHistogram(image, histogram, cumulative);
+		// Calculate cumulative histogram and sums of pixel values
+		cumulateHistogram(histogram, cumulative);
 
-		// Calculate sums of pixel values
 		pixelSums[0] = 0;
 		for (int g = 1; g < 256; g++)
-			pixelSums[g] = pixelSums[g - 1] + g * histogram[g];
+			pixelSums[g] = pixelSums[g - 1] + (uint64_t)g * histogram[g];
+
+		unsigned numberPixels = cumulative[255];
+		if (numberPixels == 0)
+			return 0;
 
 		// Init threshold at 50 % of pixels
 		while (cumulative[thresh] < (numberPixels / 2))
@@ -66,20 +124,67 @@ namespace ip
 			lastThresh = thresh;
 			thresh = (uchar)(0.5 * (meanBack + meanFore));
 		}
+		return thresh;
+	}
 
-		// Apply threshold
-		cv::threshold(image, binImage, thresh, 255, cv::THRESH_BINARY);
+	/*! Get half widths of the lines of a disk-sized neighborhood kernel.
+	*
+	* \param radius [in] Radius of the disk-sized neighborhood
+	* \param lineKernelSizes [out] Half width k for each of the 2 * radius + 1 lines
+	*/
+	static void getDiskLineWidths(int radius, int* lineKernelSizes) {
+		// Get half width dx = k for each line of the disk-sized neighborhood kernel
+		for (int dy = -radius; dy <= 0; dy++) {
+			for (int dx = -radius; dx <= 0; dx++) {
+				double distance = sqrt(dx * dx + dy * dy);
 
-		// Return calculated threshold
-		if (calculatedThresh != NULL)
-			*calculatedThresh = thresh;
+				if (distance <= radius) {
+					lineKernelSizes[radius + dy] = -dx;
+					lineKernelSizes[radius - dy] = -dx;
+					break;
+				}
+			}
+		}
+	}
+
+	/*! Apply Bernsen threshold to one pixel by scanning its disk-sized neighborhood.
+	*
+	* \param image [in] Input image g(x,y) (type CV_8U)
+	* \param x [in] Column of the pixel (at least radius from the border)
+	* \param y [in] Row of the pixel (at least radius from the border)
+	* \param radius [in] Radius of the disk-sized neighborhood
+	* \param lineKernelSizes [in] Half widths of the neighborhood lines
+	* \param minContrast [in] Minimum contrast
+	* \param dst [in,out] Resulting binary pixel (unchanged for low contrast)
+	*/
+	static inline void bernsenPixel(const cv::Mat& image, int x, int y, int radius, const int* lineKernelSizes, uchar minContrast, uchar& dst) {
+		// Determine minimum and maximum pixel value in neighborhood
+		uchar min = 255, max = 0;
+
+		for (int v = y - radius; v <= y + radius; v++) {
+			const uchar* row = image.ptr<uchar>(v);
+			int k = lineKernelSizes[v - (y - radius)];
+
+			for (int u = x - k; u <= x + k; u++) {
+				if (row[u] < min)
+					min = row[u];
+				if (row[u] > max)
+					max = row[u];
+			}
+		}
+
+		// Apply threshold
+		if (max - min >= minContrast) {
+			uchar thresh = (min + max) / 2;
+			dst = (image.at<uchar>(y, x) > thresh) * 255;
+		}
 	}
 
 	/*! Apply locally adaptive threshold using the method by Bernsen.
 	*
 	* Reference: W. Burger, M. Burge: Digitale Bildverarbeitung, 3. Auflage, Springer, S. 291.
 	*
-	* The implementation uses a squared instead of a circular neighborhood.
+	* The implementation uses a disk-sized neighborhood. Horizontal bands of rows are processed in parallel.
 	*
 	* \param image [in] Input image g(x,y) to apply threshold to (type CV_8U)
 	* \param binImage [out] Resulting binary image with values in {0, 255}
@@ -91,50 +196,75 @@ namespace ip
 		int kernelSize = 2 * radius + 1;
 		int* lineKernelSizes = new int[kernelSize] { 0 };
 
-		// Get half width dx = k for each line of the disk-sized neighborhood kernel
-		for (int dy = -radius; dy <= 0; dy++) {
-			for (int dx = -radius; dx <= 0; dx++) {
-				double distance = sqrt(dx * dx + dy * dy);
+		getDiskLineWidths(radius, lineKernelSizes);
 
-				if (distance <= radius) {
-					lineKernelSizes[radius + dy] = -dx;
-					lineKernelSizes[radius - dy] = -dx;
-					break;
-				}
+		// Init binary image as "background"
+		binImage = background * cv::Mat::ones(image.rows, image.cols, CV_8U);
+
+		// Run through image pixels (horizontal bands in parallel)
+		parallelRows(image.rows, radius, [&](const RowBand& band) {
+			for (int y = std::max(band.rowBegin, radius); y < std::min(band.rowEnd, image.rows - radius); y++) {
+				uchar* dstRow = binImage.ptr<uchar>(y);
+
+				for (int x = radius; x < image.cols - radius; x++)
+					bernsenPixel(image, x, y, radius, lineKernelSizes, minContrast, dstRow[x]);
 			}
+		});
+
+		// Free dynamic memory
+		delete[] lineKernelSizes;
+	}
+
+	/*! Apply locally adaptive threshold using the method by Bernsen and a precomputed integral image.
+	*
+	* Results are identical to bernsenThreshold() without integral image. Extrema cannot be
+	* derived from sums, but a constant neighborhood can: The bounding square of the disk is
+	* constant if and only if n * sum(g^2) = sum(g)^2 (zero variance). Such pixels are set
+	* in O(1) without scanning the neighborhood, which pays off for large homogeneous regions.
+	*
+	* \param image [in] Input image g(x,y) to apply threshold to (type CV_8U)
+	* \param integral [in] Integral image of the input image (including squares)
+	* \param binImage [out] Resulting binary image with values in {0, 255}
+	* \param radius [in] Radius of the disk-sized neighborhood
+	* \param minContrast [in] Minimum contrast
+	* \param background [in] Gray-value of background in binary image
+	*/
+	void bernsenThreshold(const cv::Mat& image, const IntegralImage& integral, cv::Mat& binImage, int radius, uchar minContrast, uchar background) {
+		// Fall back to scanning all neighborhoods without a suitable integral image
+		if (!integral.hasSquares() || (integral.size() != image.size())) {
+			cout << "[WARNING] Integral image of squares with matching size expected." << endl;
+			bernsenThreshold(image, binImage, radius, minContrast, background);
+			return;
 		}
 
+		int kernelSize = 2 * radius + 1;
+		int* lineKernelSizes = new int[kernelSize] { 0 };
+		uint64_t numberPixels = (uint64_t)kernelSize * kernelSize;
+
+		getDiskLineWidths(radius, lineKernelSizes);
+
 		// Init binary image as "background"
 		binImage = background * cv::Mat::ones(image.rows, image.cols, CV_8U);
 
-		// Run through image pixels
-		for (int y = radius; y < image.rows - radius; y++) {
-			const uchar* srcRow = image.ptr<uchar>(y);
-			uchar* dstRow = binImage.ptr<uchar>(y);
-
-			for (int x = radius; x < image.cols - radius; x++) {
-				// Determine minimum and maximum pixel value in neighborhood
-				uchar min = 255, max = 0;
+		// Run through image pixels (horizontal bands in parallel)
+		parallelRows(image.rows, radius, [&](const RowBand& band) {
+			for (int y = std::max(band.rowBegin, radius); y < std::min(band.rowEnd, image.rows - radius); y++) {
+				uchar* dstRow = binImage.ptr<uchar>(y);
 
-				for (int v = y - radius; v <= y + radius; v++) {
-					const uchar* row = image.ptr<uchar>(v);
-					int k = lineKernelSizes[v - (y - radius)];
+				for (int x = radius; x < image.cols - radius; x++) {
+					uint64_t sum = integral.sum(x - radius, y - radius, kernelSize, kernelSize);
+					uint64_t squaredSum = integral.squaredSum(x - radius, y - radius, kernelSize, kernelSize);
 
-					for (int u = x - k; u <= x + k; u++) {
-						if (row[u] < min)
-							min = row[u];
-						else if (row[u] > max)
-							max = row[u];
+					// Constant neighborhood (of at least two pixels): zero contrast, threshold equals pixel value
+					if ((radius > 0) && (numberPixels * squaredSum == sum * sum)) {
+						if (minContrast == 0)
+							dstRow[x] = 0;
 					}
-				}
-
-				// Apply threshold
-				if (max - min >= minContrast) {
-					uchar thresh = (min + max) / 2;
-					dstRow[x] = (srcRow[x] > thresh) * 255;
+					else
+						bernsenPixel(image, x, y, radius, lineKernelSizes, minContrast, dstRow[x]);
 				}
 			}
-		}
+		});
 
 		// Free dynamic memory
 		delete[] lineKernelSizes;
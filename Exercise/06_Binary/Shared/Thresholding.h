@@ -11,12 +11,16 @@
 
 /* Include files */
 #include <opencv2/core/core.hpp>
+#include "IntegralImage.h"
 
 namespace ip
 {
 	void threshold(const cv::Mat& image, cv::Mat& binImage, uchar thresh, bool isInvert = false);
 	void isodataThreshold(const cv::Mat& image, cv::Mat& binImage, uchar* calculatedThresh = NULL);
+	void isodataThreshold(const cv::Mat& image, cv::Mat& binImage, int stride, unsigned histogram[256], uchar* calculatedThresh = NULL);
+	uchar calcIsodataThreshold(const unsigned histogram[256]);
 	void bernsenThreshold(const cv::Mat& image, cv::Mat& binImage, int radius, uchar minContrast, uchar background = 0);
+	void bernsenThreshold(const cv::Mat& image, const IntegralImage& integral, cv::Mat& binImage, int radius, uchar minContrast, uchar background = 0);
 }
 
 #endif /* IP_THRESHOLDING_H */
@@ -15,6 +15,7 @@
 #include <opencv2/imgproc/imgproc.hpp>
 #include "Histogram.h"
 #include "Thresholding.h"
+#include "IntegralImage.h"
 
 /* Defines */
 #define IMAGE_DATA_PATH getenv("ImagingData")				// Read environment variable ImagingData
@@ -39,6 +40,7 @@ void onTrackbarLocalAdaptive(int valueNotUsed, void* pointerNotUsed);
 /* Global variables */
 cv::Mat histogramImage;
 cv::Mat image, binImageThresh, binImageGlobal, binImageLocal;
+ip::IntegralImage integral;
 
 /* Main function */
 int main()
@@ -55,12 +57,15 @@ int main()
 	// Calculate histogram
 	ip::createHistogramImage(image, histogramImage);
 
+	// Calculate integral image once (reused by all locally adaptive thresholds)
+	integral.compute(image);
+
 	// Apply global, adaptive global, and locally adaptive threshold
 	uchar adaptiveThresh = 0;
 
 	ip::threshold(image, binImageThresh, INITIAL_THRESHOLD);
 	ip::isodataThreshold(image, binImageGlobal, &adaptiveThresh);
-	ip::bernsenThreshold(image, binImageLocal, LOCAL_THRESH_RADIUS, LOCAL_THRESH_MIN_CONTRAST);
+	ip::bernsenThreshold(image, integral, binImageLocal, LOCAL_THRESH_RADIUS, LOCAL_THRESH_MIN_CONTRAST);
 
 	// Draw adaptive global threshold in histogram image
 	ip::addLineToHistogramImage(histogramImage, adaptiveThresh);
@@ -109,6 +114,6 @@ void onTrackbarLocalAdaptive(int valueNotUsed, void* pointerNotUsed) {
 	int kernelSize = cv::getTrackbarPos(TRACKBAR_NAME_RADIUS, WINDOW_NAME_LOCAL);
 	int minContrast = cv::getTrackbarPos(TRACKBAR_NAME_MIN_CONTRAST, WINDOW_NAME_LOCAL);
 
-	ip::bernsenThreshold(image, binImageLocal, kernelSize, minContrast);
+	ip::bernsenThreshold(image, integral, binImageLocal, kernelSize, minContrast);
 	cv::imshow(WINDOW_NAME_LOCAL, binImageLocal);
 }
@@ -6,9 +6,12 @@
 
 
 /* Include files */
-#include <cstdint>						// Declare int32_t
+#include <cstdint>						// Declare int32_t, int64_t
+#include <iostream>
+#include <mutex>
 #include <opencv2/imgproc/imgproc.hpp>
 #include "TemplateMatching.h"
+#include "Parallel.h"
 
 /* Namespaces */
 using namespace std;
@@ -17,6 +20,8 @@ namespace ip {
 
 	/*! Template matching using sum of squared differences (SSD).
 	* 
+	* Horizontal bands of SSD rows are calculated in parallel.
+	* 
 	* \param image [in] Source image
 	* \param object [in] Template to search for in source image
 	* \param ssdImage [out] Calculated sums of squared differences (SSD)
@@ -36,38 +41,150 @@ namespace ip {
 		// Allocate resulting image (sum of squared differences)
 		ssdImage = cv::Mat(cv::Size(ssdCols, ssdRows), CV_32S);
 
-		// Run through upper left corners (x, y) in source image
-		for (int y = 0; y < ssdRows; y++) {
-			for (int x = 0; x < ssdCols; x++) {
-				int32_t* ssdRow = (int32_t*)ssdImage.ptr<int32_t>(y);
-				int32_t ssd = 0;
+		// Run through upper left corners (x, y) in source image (horizontal bands in parallel)
+		mutex resultMutex;
+
+		parallelRows(ssdRows, 0, [&](const RowBand& band) {
+			int32_t bandMinSSD = INT32_MAX, bandMaxSSD = -1;
+			cv::Point bandBestMatch;
 
-				// Calculate SSD for template and source image at (x, y)
-				for (int n = 0; n < object.rows; n++) {
-					const uchar* imageRow = (uchar*)image.ptr<uchar>(y + n);
-					const uchar* objectRow = (uchar*)object.ptr<uchar>(n);
+			for (int y = band.rowBegin; y < band.rowEnd; y++) {
+				for (int x = 0; x < ssdCols; x++) {
+					int32_t* ssdRow = (int32_t*)ssdImage.ptr<int32_t>(y);
+					int32_t ssd = 0;
 
-					for (int m = 0; m < object.cols; m++) {
-						int32_t difference = (int32_t)imageRow[x + m] - (int32_t)objectRow[m];
-						ssd += difference * difference;
+					// Calculate SSD for template and source image at (x, y)
+					for (int n = 0; n < object.rows; n++) {
+						const uchar* imageRow = (uchar*)image.ptr<uchar>(y + n);
+						const uchar* objectRow = (uchar*)object.ptr<uchar>(n);
+
+						for (int m = 0; m < object.cols; m++) {
+							int32_t difference = (int32_t)imageRow[x + m] - (int32_t)objectRow[m];
+							ssd += difference * difference;
+						}
 					}
-				}
-				ssdRow[x] = ssd;
+					ssdRow[x] = ssd;
 
-				// Determine minimum SSD (= best match)
-				if (ssd < minSSD) {
-					minSSD = ssd;
-					bestMatch.x = x;
-					bestMatch.y = y;
+					// Determine minimum SSD (= best match)
+					if (ssd < bandMinSSD) {
+						bandMinSSD = ssd;
+						bandBestMatch.x = x;
+						bandBestMatch.y = y;
+					}
+
+					// Determine maximum SSD (to scale contrast)
+					if (ssd > bandMaxSSD)
+						bandMaxSSD = ssd;
 				}
+			}
 
-				// Determine maximum SSD (to scale contrast)
-				if (ssd > maxSSD)
-					maxSSD = ssd;
+			// Merge band results (first match in row order on equal SSDs, like a serial scan)
+			lock_guard<mutex> lock(resultMutex);
+			if ((bandMinSSD < minSSD) || ((bandMinSSD == minSSD) && (bandMinSSD != INT32_MAX) && (bandBestMatch.y < bestMatch.y))) {
+				minSSD = bandMinSSD;
+				bestMatch = bandBestMatch;
 			}
-		}
+			maxSSD = max(maxSSD, bandMaxSSD);
+		});
 
 		// Convert SSD image to 8-bit grayscale in [min, 255]
 		ssdImage.convertTo(ssdImage, CV_8U, 255.0 / maxSSD);
 	}
+
+	/*! Template matching using sum of squared differences (SSD) and a precomputed integral image.
+	*
+	* The SSD is expanded into sum(g^2) - 2 sum(g t) + sum(t^2). The sum of squared image values
+	* is read from the integral image in O(1), the sum of squared template values is computed once.
+	* Only the cross-correlation sum(g t) remains per location, which avoids the subtraction and
+	* is accumulated as a plain multiply-add loop. SSDs are accumulated in 64 bit and saturated
+	* when stored, hence the results are identical to templateMatching() without integral image.
+	*
+	* \param image [in] Source image
+	* \param integral [in] Integral image of the source image (including squares)
+	* \param object [in] Template to search for in source image
+	* \param ssdImage [out] Calculated sums of squared differences (SSD)
+	* \param bestMatch [out] Location with minimum SSD
+	*/
+	void templateMatching(const cv::Mat& image, const IntegralImage& integral, const cv::Mat& object, cv::Mat& ssdImage, cv::Point& bestMatch) {
+		int ssdCols = image.cols - object.cols + 1;
+		int ssdRows = image.rows - object.rows + 1;
+		int64_t minSSD = INT64_MAX, maxSSD = -1;
+		int64_t objectSquares = 0;
+
+		// Error: Template image not smaller than source image
+		if ((ssdCols < 1) || (ssdRows < 1)) {
+			ssdImage = cv::Mat();
+			return;
+		}
+
+		// Fall back to direct SSD calculation without a suitable integral image
+		if (!integral.hasSquares() || (integral.size() != image.size())) {
+			cout << "[WARNING] Integral image of squares with matching size expected." << endl;
+			templateMatching(image, object, ssdImage, bestMatch);
+			return;
+		}
+
+		// Sum of squared template values (constant for all locations)
+		for (int n = 0; n < object.rows; n++) {
+			const uchar* objectRow = object.ptr<uchar>(n);
+
+			for (int m = 0; m < object.cols; m++)
+				objectSquares += (int32_t)objectRow[m] * objectRow[m];
+		}
+
+		// Allocate resulting image (sum of squared differences)
+		ssdImage = cv::Mat(cv::Size(ssdCols, ssdRows), CV_32S);
+
+		// Run through upper left corners (x, y) in source image (horizontal bands in parallel)
+		mutex resultMutex;
+
+		parallelRows(ssdRows, 0, [&](const RowBand& band) {
+			int64_t bandMinSSD = INT64_MAX, bandMaxSSD = -1;
+			cv::Point bandBestMatch;
+
+			for (int y = band.rowBegin; y < band.rowEnd; y++) {
+				int32_t* ssdRow = ssdImage.ptr<int32_t>(y);
+
+				for (int x = 0; x < ssdCols; x++) {
+					int64_t crossSum = 0;
+
+					// Calculate cross-correlation for template and source image at (x, y)
+					for (int n = 0; n < object.rows; n++) {
+						const uchar* imageRow = image.ptr<uchar>(y + n) + x;
+						const uchar* objectRow = object.ptr<uchar>(n);
+						int32_t rowSum = 0;
+
+						for (int m = 0; m < object.cols; m++)
+							rowSum += (int32_t)imageRow[m] * objectRow[m];
+						crossSum += rowSum;
+					}
+
+					int64_t ssd = (int64_t)integral.squaredSum(x, y, object.cols, object.rows) - 2 * crossSum + objectSquares;
+					ssdRow[x] = (int32_t)min(ssd, (int64_t)INT32_MAX);
+
+					// Determine minimum SSD (= best match)
+					if (ssd < bandMinSSD) {
+						bandMinSSD = ssd;
+						bandBestMatch.x = x;
+						bandBestMatch.y = y;
+					}
+
+					// Determine maximum SSD (to scale contrast)
+					if (ssd > bandMaxSSD)
+						bandMaxSSD = ssd;
+				}
+			}
+
+			// Merge band results (first match in row order on equal SSDs, like a serial scan)
+			lock_guard<mutex> lock(resultMutex);
+			if ((bandMinSSD < minSSD) || ((bandMinSSD == minSSD) && (bandBestMatch.y < bestMatch.y))) {
+				minSSD = bandMinSSD;
+				bestMatch = bandBestMatch;
+			}
+			maxSSD = max(maxSSD, bandMaxSSD);
+		});
+
+		// Convert SSD image to 8-bit grayscale in [min, 255]
+		ssdImage.convertTo(ssdImage, CV_8U, 255.0 / min(maxSSD, (int64_t)INT32_MAX));
+	}
 }
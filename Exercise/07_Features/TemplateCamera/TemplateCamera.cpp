@@ -10,6 +10,7 @@
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include "TemplateMatching.h"
+#include "IntegralImage.h"
 
 /* Defines */
 #define WINDOW_NAME_CAMERA "Camera (press any key to quit)"
@@ -29,6 +30,7 @@ void annotateFrame(cv::Rect2i* mouseDragBox, cv::Point bestMatch);
 cv::Mat frame, frame8U, objectImage, ssdImage;
 cv::Rect2i* mouseDragBox;
 cv::Point bestMatch;
+ip::IntegralImage integral;
 
 /* Main function */
 int main()
@@ -51,9 +53,10 @@ int main()
 		camera >> frame;
 		cv::cvtColor(frame, frame8U, cv::COLOR_BGR2GRAY);
 
-		// Apply template matching and display SSD
+		// Apply template matching and display SSD (integral image is built once per frame)
 		if (!objectImage.empty()) {
-			ip::templateMatching(frame8U, objectImage, ssdImage, bestMatch);
+			integral.compute(frame8U);
+			ip::templateMatching(frame8U, integral, objectImage, ssdImage, bestMatch);
 			cv::imshow(WINDOW_NAME_SSD, ssdImage);
 		}
 
@@ -0,0 +1,209 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Include files */
+#include <algorithm>
+#include <iostream>
+#include <cstdint>						// Declare uint16_t, uint32_t, uint64_t
+#include <cstring>
+#include <vector>
+#include "BinomialFilter.h"
+
+/* Defines */
+#define BINOMIAL_MAX_KERNEL_SIZE 15
+
+/* Namespaces */
+using namespace std;
+
+namespace ip
+{
+	/*! Apply separable binomial filter streaming through a band of rows.
+	*
+	* The horizontal pass writes its unscaled sums into a ring buffer of K rows. As soon as
+	* the ring buffer holds the K rows around the current row, the vertical pass calculates
+	* the filtered row and passes it to the row sink. Each source row is read once (plus K - 1
+	* rows above the band), intermediate memory is O(K * width), and all arithmetic uses
+	* integer weights and a single rounding shift. Bands start with their own ring buffer,
+	* hence they can be processed in parallel.
+	*
+	* \param image [in] Source image (type CV_8U)
+	* \param weights [in] Binomial coefficients (K elements, sum 2^n)
+	* \param n [in] Binomial order (K - 1)
+	* \param rowBegin [in] First row of the band
+	* \param rowEnd [in] Row behind the last row of the band
+	* \param rowSink [in] Called with every filtered row of the band (in row order)
+	*/
+	template <BorderMode Mode, typename RowType, typename SumType>
+	static void binomialFilterRingBuffer(const cv::Mat& image, const vector<int>& weights, int n, int rowBegin, int rowEnd, const BinomialRowSink& rowSink) {
+		int kernelSize = (int)weights.size(), k = kernelSize / 2;
+		size_t cols = image.cols;
+		BorderAccessor<Mode> source(image);
+		vector<uchar> line(cols + 2 * k);
+		vector<RowType> ring(kernelSize * cols);
+		SumType rounding = (SumType)1 << (2 * n - 1);
+
+		// Horizontal pass of one (extended) source row into its ring buffer row
+		auto filterRow = [&](int y) {
+			RowType* dstRow = &ring[(size_t)((y + k) % kernelSize) * cols];
+			const uchar* srcRow = line.data();
+
+			source.paddedRow(y, k, line.data());
+			for (size_t x = 0; x < cols; x++)
+				dstRow[x] = (RowType)srcRow[x];
+			for (int m = 1; m < kernelSize; m++) {
+				RowType weight = (RowType)weights[m];
+
+				for (size_t x = 0; x < cols; x++)
+					dstRow[x] += weight * srcRow[x + m];
+			}
+		};
+
+		// Fill ring buffer with rows rowBegin - k .. rowBegin + k - 1
+		for (int y = rowBegin - k; y < rowBegin + k; y++)
+			filterRow(y);
+
+		// Run through rows of the band
+		vector<SumType> sums(cols);
+		vector<uchar> filteredRow(cols);
+
+		for (int y = rowBegin; y < rowEnd; y++) {
+			// Add row y + k, replacing row y - k - 1
+			filterRow(y + k);
+
+			// Vertical pass over ring buffer rows y - k .. y + k
+			fill(sums.begin(), sums.end(), rounding);
+			for (int v = 0; v < kernelSize; v++) {
+				const RowType* ringRow = &ring[(size_t)((y + v) % kernelSize) * cols];
+				SumType weight = (SumType)weights[v];
+
+				for (size_t x = 0; x < cols; x++)
+					sums[x] += weight * ringRow[x];
+			}
+
+			for (size_t x = 0; x < cols; x++)
+				filteredRow[x] = (uchar)(sums[x] >> (2 * n));
+			rowSink(y, filteredRow.data());
+		}
+	}
+
+	/*! Select accumulator sizes for the binomial filter.
+	*
+	* Horizontal sums are below 255 * 2^n, vertical sums below 255 * 2^(2n).
+	*
+	* \param image [in] Source image (type CV_8U)
+	* \param weights [in] Binomial coefficients (K elements, sum 2^n)
+	* \param n [in] Binomial order (K - 1)
+	* \param rowBegin [in] First row of the band
+	* \param rowEnd [in] Row behind the last row of the band
+	* \param rowSink [in] Called with every filtered row of the band
+	*/
+	template <BorderMode Mode>
+	static void binomialFilterBorder(const cv::Mat& image, const vector<int>& weights, int n, int rowBegin, int rowEnd, const BinomialRowSink& rowSink) {
+		if (n <= 8)
+			binomialFilterRingBuffer<Mode, uint16_t, uint32_t>(image, weights, n, rowBegin, rowEnd, rowSink);
+		else if (n <= 10)
+			binomialFilterRingBuffer<Mode, uint32_t, uint32_t>(image, weights, n, rowBegin, rowEnd, rowSink);
+		else
+			binomialFilterRingBuffer<Mode, uint32_t, uint64_t>(image, weights, n, rowBegin, rowEnd, rowSink);
+	}
+
+	/*! Check parameters and calculate binomial coefficients by Pascal's triangle.
+	*
+	* \param image [in] Source image to be filtered (type CV_8U)
+	* \param kernelSize [in] Size K of the KxK filter kernel (odd, at most 15)
+	* \param weights [out] Binomial coefficients (n over i) with n = K - 1
+	* \return true for valid parameters
+	*/
+	static bool binomialWeights(const cv::Mat& image, int kernelSize, vector<int>& weights) {
+		// Assert correct parameters
+		if (image.type() != CV_8U) {
+			cout << "[WARNING] Incorrect image type. CV_8U expected." << endl;
+			return false;
+		}
+		if (((kernelSize % 2) == 0) || (kernelSize < 3) || (kernelSize > BINOMIAL_MAX_KERNEL_SIZE)) {
+			cout << "[WARNING] Kernel size must be odd and within [3, " << BINOMIAL_MAX_KERNEL_SIZE << "]." << endl;
+			return false;
+		}
+
+		weights.assign(kernelSize, 0);
+		weights[0] = 1;
+		for (int i = 1; i < kernelSize; i++) {
+			for (int j = i; j > 0; j--)
+				weights[j] += weights[j - 1];
+		}
+		return true;
+	}
+
+	/*! Apply KxK binomial filter to a band of rows.
+	*
+	* Same arithmetic and border handling as binomialFilter(), but the filtered rows are passed
+	* to a row sink instead of being stored, e. g., to fuse further point operations into the
+	* filter pass (see unsharp masking of Lab 1).
+	*
+	* \param image [in] Source image to be filtered (type CV_8U, must not be written by the sink)
+	* \param kernelSize [in] Size K of the KxK filter kernel (odd, at most 15)
+	* \param rowBegin [in] First row of the band
+	* \param rowEnd [in] Row behind the last row of the band
+	* \param rowSink [in] Called with every filtered row of the band (in row order)
+	* \param border [in] Border extension mode
+	*/
+	void binomialFilterRows(const cv::Mat& image, int kernelSize, int rowBegin, int rowEnd, const BinomialRowSink& rowSink, BorderMode border) {
+		vector<int> weights;
+
+		if (!binomialWeights(image, kernelSize, weights))
+			return;
+
+		int n = kernelSize - 1;
+		rowBegin = max(rowBegin, 0);
+		rowEnd = min(rowEnd, image.rows);
+
+		// Select implementation for border mode
+		switch (border) {
+		case BORDER_ZERO:
+			binomialFilterBorder<BORDER_ZERO>(image, weights, n, rowBegin, rowEnd, rowSink);
+			break;
+		case BORDER_WRAP:
+			binomialFilterBorder<BORDER_WRAP>(image, weights, n, rowBegin, rowEnd, rowSink);
+			break;
+		case BORDER_REFLECT:
+			binomialFilterBorder<BORDER_REFLECT>(image, weights, n, rowBegin, rowEnd, rowSink);
+			break;
+		default:
+			binomialFilterBorder<BORDER_CLAMP>(image, weights, n, rowBegin, rowEnd, rowSink);
+		}
+	}
+
+	/*! Apply KxK binomial filter.
+	*
+	* The binomial coefficients (n over i) with n = K - 1 are applied as integer weights,
+	* the result is divided by 2^(2n) by a rounding shift (no floating point operations).
+	* Ring buffer rows hold the full-precision horizontal sums (16 bit up to K = 9).
+	*
+	* Example: K = 9 yields the kernel (1, 8, 28, 56, 70, 56, 28, 8, 1) / 256 per direction.
+	*
+	* \param image [in] Source image to be filtered (type CV_8U)
+	* \param filtered [out] Destination image
+	* \param kernelSize [in] Size K of the KxK filter kernel (odd, at most 15)
+	* \param border [in] Border extension mode
+	*/
+	void binomialFilter(const cv::Mat& image, cv::Mat& filtered, int kernelSize, BorderMode border) {
+		vector<int> weights;
+
+		if (!binomialWeights(image, kernelSize, weights)) {
+			filtered = image.clone();
+			return;
+		}
+
+		// Keep source intact when filtering in place
+		cv::Mat source = (image.data == filtered.data) ? image.clone() : image;
+		filtered.create(image.rows, image.cols, CV_8U);
+
+		binomialFilterRows(source, kernelSize, 0, source.rows, [&](int y, const uchar* filteredRow) {
+			memcpy(filtered.ptr<uchar>(y), filteredRow, source.cols);
+		}, border);
+	}
+}
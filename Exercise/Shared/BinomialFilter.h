@@ -0,0 +1,26 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_BINOMIAL_FILTER_H
+#define IP_BINOMIAL_FILTER_H
+
+/* Include files */
+#include <functional>
+#include <opencv2/core/core.hpp>
+#include "BorderAccessor.h"
+
+namespace ip
+{
+	/* Datatypes */
+	typedef std::function<void(int y, const uchar* filteredRow)> BinomialRowSink;	// Receives each filtered row
+
+	void binomialFilter(const cv::Mat& image, cv::Mat& filtered, int kernelSize, BorderMode border = BORDER_CLAMP);
+	void binomialFilterRows(const cv::Mat& image, int kernelSize, int rowBegin, int rowEnd, const BinomialRowSink& rowSink, BorderMode border = BORDER_CLAMP);
+}
+
+#endif /* IP_BINOMIAL_FILTER_H */
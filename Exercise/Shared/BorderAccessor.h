@@ -0,0 +1,139 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_BORDER_ACCESSOR_H
+#define IP_BORDER_ACCESSOR_H
+
+/* Include files */
+#include <cstring>						// Declare memcpy()
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+namespace ip
+{
+	/*! Border extension modes for pixels outside the image.
+	*
+	* Example for a line "abcd" extended by 3 pixels on each side:
+	* - BORDER_ZERO:    000|abcd|000
+	* - BORDER_WRAP:    bcd|abcd|abc (cyclic)
+	* - BORDER_REFLECT: cba|abcd|dcb (mirror, border pixel repeated)
+	* - BORDER_CLAMP:   aaa|abcd|ddd (closest border pixel)
+	*/
+	enum BorderMode { BORDER_ZERO, BORDER_WRAP, BORDER_REFLECT, BORDER_CLAMP };
+
+	/*! Read access to an 8-bit grayscale image extended beyond its borders.
+	*
+	* Filters use the accessor instead of a padded copy of the image. Rows inside the image
+	* are returned as plain row pointers, so the interior costs nothing extra. Only rows
+	* and columns outside the image are mapped according to the border mode. As the mode
+	* is a template parameter, the mapping is resolved at compile time.
+	*
+	* Filters working on lines (e. g., running sums, separable passes) extend their line
+	* buffers by extendLine(), which only writes the thin border strips.
+	*/
+	template <BorderMode Mode>
+	class BorderAccessor {
+	public:
+		explicit BorderAccessor(const cv::Mat& image) : image(image), zeroRow(image.cols, 0) {}
+
+		static inline int index(int i, int length);
+		template <typename T> static inline void extendLine(T* line, int length, int border);
+
+		inline const uchar* row(int y) const;
+		inline uchar at(int y, int x) const;
+		inline void paddedRow(int y, int border, uchar* line) const;
+
+	private:
+		cv::Mat image;
+		std::vector<uchar> zeroRow;
+	};
+
+	/*! Map a coordinate to the corresponding coordinate inside the image.
+	*
+	* \param i Coordinate (may be outside [0, length), also by more than length)
+	* \param length Image width or height
+	* \return coordinate inside [0, length), or -1 for zero padding
+	*/
+	template <BorderMode Mode>
+	inline int BorderAccessor<Mode>::index(int i, int length) {
+		if ((unsigned)i < (unsigned)length)
+			return i;
+
+		switch (Mode) {
+		case BORDER_ZERO:
+			return -1;
+		case BORDER_WRAP:
+			return ((i % length) + length) % length;
+		case BORDER_REFLECT: {
+			int period = 2 * length;
+			i = ((i % period) + period) % period;
+			return (i < length) ? i : period - 1 - i;
+		}
+		default:
+			return (i < 0) ? 0 : length - 1;
+		}
+	}
+
+	/*! Fill the border strips of a line buffer from its inner elements.
+	*
+	* \param line Pointer to the first inner element (border elements are located before
+	*             line[0] and after line[length - 1])
+	* \param length Number of inner elements
+	* \param border Number of border elements on each side
+	*/
+	template <BorderMode Mode>
+	template <typename T>
+	inline void BorderAccessor<Mode>::extendLine(T* line, int length, int border) {
+		for (int m = 1; m <= border; m++) {
+			int left = index(-m, length), right = index(length - 1 + m, length);
+
+			line[-m] = (left < 0) ? (T)0 : line[left];
+			line[length - 1 + m] = (right < 0) ? (T)0 : line[right];
+		}
+	}
+
+	/*! Get pointer to an (extended) image row.
+	*
+	* \param y Row (may be outside the image)
+	* \return pointer to the image row the border mode maps to, or to a row of zeros
+	*/
+	template <BorderMode Mode>
+	inline const uchar* BorderAccessor<Mode>::row(int y) const {
+		if ((unsigned)y < (unsigned)image.rows)
+			return image.ptr<uchar>(y);
+
+		int n = index(y, image.rows);
+		return (n < 0) ? zeroRow.data() : image.ptr<uchar>(n);
+	}
+
+	/*! Get a single (extended) pixel value.
+	*
+	* \param y Row (may be outside the image)
+	* \param x Column (may be outside the image)
+	* \return pixel value according to the border mode
+	*/
+	template <BorderMode Mode>
+	inline uchar BorderAccessor<Mode>::at(int y, int x) const {
+		int m = index(x, image.cols);
+		return (m < 0) ? 0 : row(y)[m];
+	}
+
+	/*! Copy an (extended) image row into a line buffer including border strips.
+	*
+	* \param y Row (may be outside the image)
+	* \param border Number of border pixels on each side
+	* \param line Line buffer with image width + 2 * border elements
+	*/
+	template <BorderMode Mode>
+	inline void BorderAccessor<Mode>::paddedRow(int y, int border, uchar* line) const {
+		memcpy(line + border, row(y), image.cols);
+		extendLine(line + border, image.cols, border);
+	}
+}
+
+#endif /* IP_BORDER_ACCESSOR_H */
@@ -0,0 +1,446 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_CLAMP_H
+#define IP_CLAMP_H
+
+/* Include files */
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <opencv2/core/core.hpp>
+#include "Parallel.h"
+#include "Simd.h"
+
+#ifdef IP_SIMD_X86
+#include <immintrin.h>					// SSE2 and AVX2 intrinsics
+#endif
+
+namespace ip
+{
+	/*! Keep ("clamp") a value inside a specific range [min, max].
+	*
+	* \param value Value to clamp
+	* \param min Lower bound of the range
+	* \param max Upper bound of the range
+	* \return value clamped to [min, max]
+	*/
+	inline uchar clamp(int value, uchar min, uchar max) {
+		return (uchar)std::min(std::max(value, (int)min), (int)max);
+	}
+
+	/*! Keep a value of any type inside a specific range [min, max] (without branches).
+	*
+	* \param value Value to clamp
+	* \param min Lower bound of the range
+	* \param max Upper bound of the range
+	* \return value clamped to [min, max]
+	*/
+	template <typename T>
+	inline T clampValue(T value, T min, T max) {
+		return std::min(std::max(value, min), max);
+	}
+
+#ifdef IP_SIMD_X86
+	// Clamp rows in place by vector min/max, return the number of values processed.
+	// Types without suitable instructions on a level process no values (scalar loop only).
+	// Float min/max return the second operand if one is NaN, so the values go second and
+	// NaN stays NaN as in clampValue().
+	template <typename T>
+	static inline int clampRowSse2(T*, int, T, T) { return 0; }
+	template <typename T>
+	static inline int clampRowAvx2(T*, int, T, T) { return 0; }
+
+	static inline IP_TARGET_SSE2 int clampRowSse2(uchar* data, int count, uchar min, uchar max) {
+		const __m128i low = _mm_set1_epi8((char)min), high = _mm_set1_epi8((char)max);
+		int x = 0;
+
+		for (; x + 16 <= count; x += 16) {
+			__m128i values = _mm_loadu_si128((const __m128i*)(data + x));
+			_mm_storeu_si128((__m128i*)(data + x), _mm_min_epu8(_mm_max_epu8(values, low), high));
+		}
+		return x;
+	}
+
+	// Unsigned 16 bit without SSE4.1: max(v, low) = low + (v -sat low), min(v, high) = v - (v -sat high)
+	static inline IP_TARGET_SSE2 int clampRowSse2(ushort* data, int count, ushort min, ushort max) {
+		const __m128i low = _mm_set1_epi16((short)min), high = _mm_set1_epi16((short)max);
+		int x = 0;
+
+		for (; x + 8 <= count; x += 8) {
+			__m128i values = _mm_add_epi16(low, _mm_subs_epu16(_mm_loadu_si128((const __m128i*)(data + x)), low));
+			_mm_storeu_si128((__m128i*)(data + x), _mm_sub_epi16(values, _mm_subs_epu16(values, high)));
+		}
+		return x;
+	}
+
+	static inline IP_TARGET_SSE2 int clampRowSse2(short* data, int count, short min, short max) {
+		const __m128i low = _mm_set1_epi16(min), high = _mm_set1_epi16(max);
+		int x = 0;
+
+		for (; x + 8 <= count; x += 8) {
+			__m128i values = _mm_loadu_si128((const __m128i*)(data + x));
+			_mm_storeu_si128((__m128i*)(data + x), _mm_min_epi16(_mm_max_epi16(values, low), high));
+		}
+		return x;
+	}
+
+	static inline IP_TARGET_SSE2 int clampRowSse2(float* data, int count, float min, float max) {
+		const __m128 low = _mm_set1_ps(min), high = _mm_set1_ps(max);
+		int x = 0;
+
+		for (; x + 4 <= count; x += 4)
+			_mm_storeu_ps(data + x, _mm_min_ps(high, _mm_max_ps(low, _mm_loadu_ps(data + x))));
+		return x;
+	}
+
+	static inline IP_TARGET_SSE2 int clampRowSse2(double* data, int count, double min, double max) {
+		const __m128d low = _mm_set1_pd(min), high = _mm_set1_pd(max);
+		int x = 0;
+
+		for (; x + 2 <= count; x += 2)
+			_mm_storeu_pd(data + x, _mm_min_pd(high, _mm_max_pd(low, _mm_loadu_pd(data + x))));
+		return x;
+	}
+
+	static inline IP_TARGET_AVX2 int clampRowAvx2(uchar* data, int count, uchar min, uchar max) {
+		const __m256i low = _mm256_set1_epi8((char)min), high = _mm256_set1_epi8((char)max);
+		int x = 0;
+
+		for (; x + 32 <= count; x += 32) {
+			__m256i values = _mm256_loadu_si256((const __m256i*)(data + x));
+			_mm256_storeu_si256((__m256i*)(data + x), _mm256_min_epu8(_mm256_max_epu8(values, low), high));
+		}
+		return x;
+	}
+
+	static inline IP_TARGET_AVX2 int clampRowAvx2(schar* data, int count, schar min, schar max) {
+		const __m256i low = _mm256_set1_epi8(min), high = _mm256_set1_epi8(max);
+		int x = 0;
+
+		for (; x + 32 <= count; x += 32) {
+			__m256i values = _mm256_loadu_si256((const __m256i*)(data + x));
+			_mm256_storeu_si256((__m256i*)(data + x), _mm256_min_epi8(_mm256_max_epi8(values, low), high));
+		}
+		return x;
+	}
+
+	static inline IP_TARGET_AVX2 int clampRowAvx2(ushort* data, int count, ushort min, ushort max) {
+		const __m256i low = _mm256_set1_epi16((short)min), high = _mm256_set1_epi16((short)max);
+		int x = 0;
+
+		for (; x + 16 <= count; x += 16) {
+			__m256i values = _mm256_loadu_si256((const __m256i*)(data + x));
+			_mm256_storeu_si256((__m256i*)(data + x), _mm256_min_epu16(_mm256_max_epu16(values, low), high));
+		}
+		return x;
+	}
+
+	static inline IP_TARGET_AVX2 int clampRowAvx2(short* data, int count, short min, short max) {
+		const __m256i low = _mm256_set1_epi16(min), high = _mm256_set1_epi16(max);
+		int x = 0;
+
+		for (; x + 16 <= count; x += 16) {
+			__m256i values = _mm256_loadu_si256((const __m256i*)(data + x));
+			_mm256_storeu_si256((__m256i*)(data + x), _mm256_min_epi16(_mm256_max_epi16(values, low), high));
+		}
+		return x;
+	}
+
+	static inline IP_TARGET_AVX2 int clampRowAvx2(int* data, int count, int min, int max) {
+		const __m256i low = _mm256_set1_epi32(min), high = _mm256_set1_epi32(max);
+		int x = 0;
+
+		for (; x + 8 <= count; x += 8) {
+			__m256i values = _mm256_loadu_si256((const __m256i*)(data + x));
+			_mm256_storeu_si256((__m256i*)(data + x), _mm256_min_epi32(_mm256_max_epi32(values, low), high));
+		}
+		return x;
+	}
+
+	static inline IP_TARGET_AVX2 int clampRowAvx2(float* data, int count, float min, float max) {
+		const __m256 low = _mm256_set1_ps(min), high = _mm256_set1_ps(max);
+		int x = 0;
+
+		for (; x + 8 <= count; x += 8)
+			_mm256_storeu_ps(data + x, _mm256_min_ps(high, _mm256_max_ps(low, _mm256_loadu_ps(data + x))));
+		return x;
+	}
+
+	static inline IP_TARGET_AVX2 int clampRowAvx2(double* data, int count, double min, double max) {
+		const __m256d low = _mm256_set1_pd(min), high = _mm256_set1_pd(max);
+		int x = 0;
+
+		for (; x + 4 <= count; x += 4)
+			_mm256_storeu_pd(data + x, _mm256_min_pd(high, _mm256_max_pd(low, _mm256_loadu_pd(data + x))));
+		return x;
+	}
+
+	// Convert 8 values to float
+	static inline IP_TARGET_AVX2 __m256 loadFloatsAvx2(const uchar* src) {
+		return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src)));
+	}
+	static inline IP_TARGET_AVX2 __m256 loadFloatsAvx2(const schar* src) {
+		return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)src)));
+	}
+	static inline IP_TARGET_AVX2 __m256 loadFloatsAvx2(const ushort* src) {
+		return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)src)));
+	}
+	static inline IP_TARGET_AVX2 __m256 loadFloatsAvx2(const short* src) {
+		return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)src)));
+	}
+	static inline IP_TARGET_AVX2 __m256 loadFloatsAvx2(const float* src) {
+		return _mm256_loadu_ps(src);
+	}
+
+	// Store 8 clamped float values (integers rounded to nearest, ties to even like cvRound())
+	static inline IP_TARGET_AVX2 __m128i roundToShortsAvx2(__m256 values) {
+		__m256i integers = _mm256_cvtps_epi32(values);
+		return _mm_packs_epi32(_mm256_castsi256_si128(integers), _mm256_extracti128_si256(integers, 1));
+	}
+	static inline IP_TARGET_AVX2 void storeFloatsAvx2(uchar* dst, __m256 values) {
+		__m128i shorts = roundToShortsAvx2(values);
+		_mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(shorts, shorts));
+	}
+	static inline IP_TARGET_AVX2 void storeFloatsAvx2(schar* dst, __m256 values) {
+		__m128i shorts = roundToShortsAvx2(values);
+		_mm_storel_epi64((__m128i*)dst, _mm_packs_epi16(shorts, shorts));
+	}
+	static inline IP_TARGET_AVX2 void storeFloatsAvx2(ushort* dst, __m256 values) {
+		__m256i integers = _mm256_cvtps_epi32(values);
+		_mm_storeu_si128((__m128i*)dst, _mm_packus_epi32(_mm256_castsi256_si128(integers), _mm256_extracti128_si256(integers, 1)));
+	}
+	static inline IP_TARGET_AVX2 void storeFloatsAvx2(short* dst, __m256 values) {
+		_mm_storeu_si128((__m128i*)dst, roundToShortsAvx2(values));
+	}
+	static inline IP_TARGET_AVX2 void storeFloatsAvx2(float* dst, __m256 values) {
+		_mm256_storeu_ps(dst, values);
+	}
+
+	template <typename Src, typename Dst>
+	static IP_TARGET_AVX2 int convertClampRowAvx2(const Src* src, Dst* dst, int count, float alpha, float beta, float min, float max, bool isAbsolute) {
+		const __m256 scale = _mm256_set1_ps(alpha), offset = _mm256_set1_ps(beta);
+		const __m256 low = _mm256_set1_ps(min), high = _mm256_set1_ps(max), signBit = _mm256_set1_ps(-0.0f);
+		int x = 0;
+
+		for (; x + 8 <= count; x += 8) {
+			__m256 values = _mm256_add_ps(_mm256_mul_ps(loadFloatsAvx2(src + x), scale), offset);
+
+			if (isAbsolute)
+				values = _mm256_andnot_ps(signBit, values);
+			storeFloatsAvx2(dst + x, _mm256_min_ps(high, _mm256_max_ps(low, values)));
+		}
+		return x;
+	}
+#endif
+
+	/*! Clamp values of a row to [min, max] in place.
+	*
+	* \param data [in,out] Values
+	* \param count [in] Number of values
+	* \param min [in] Lower bound
+	* \param max [in] Upper bound
+	*/
+	template <typename T>
+	inline void clampRow(T* data, int count, T min, T max) {
+		int x = 0;
+
+#ifdef IP_SIMD_X86
+		SimdLevel level = getSimdLevel();
+		if (level >= SIMD_AVX2)
+			x = clampRowAvx2(data, count, min, max);
+		else if (level >= SIMD_SSE2)
+			x = clampRowSse2(data, count, min, max);
+#endif
+
+		// Scalar reference (and remaining values)
+		for (; x < count; x++)
+			data[x] = clampValue(data[x], min, max);
+	}
+
+	/*! Convert a row to another type, dst = clamp(alpha * src + beta) or clamp(|alpha * src + beta|).
+	*
+	* Values are computed in single precision and rounded to nearest (ties to even) for integer types.
+	*
+	* \param src [in] Source values
+	* \param dst [out] Resulting values (may be src, if the types have the same size)
+	* \param count [in] Number of values
+	* \param alpha [in] Scale
+	* \param beta [in] Offset
+	* \param min [in] Lower bound (within the range of Dst)
+	* \param max [in] Upper bound (within the range of Dst)
+	* \param isAbsolute [in] Take the absolute value before clamping, if true
+	*/
+	template <typename Src, typename Dst>
+	inline void convertClampRow(const Src* src, Dst* dst, int count, float alpha, float beta, float min, float max, bool isAbsolute) {
+		int x = 0;
+
+#ifdef IP_SIMD_X86
+		if (getSimdLevel() >= SIMD_AVX2)
+			x = convertClampRowAvx2(src, dst, count, alpha, beta, min, max, isAbsolute);
+#endif
+
+		// Scalar reference (and remaining values)
+		for (; x < count; x++) {
+			float value = alpha * (float)src[x] + beta;
+
+			if (isAbsolute)
+				value = std::fabs(value);
+			value = clampValue(value, min, max);
+			dst[x] = std::numeric_limits<Dst>::is_integer ? (Dst)cvRound(value) : (Dst)value;
+		}
+	}
+
+	/*! Clamp all values of an image of a specific type to [min, max] in place.
+	*
+	* \param image [in,out] Image (any number of channels)
+	* \param min [in] Lower bound (saturated to the range of T)
+	* \param max [in] Upper bound (saturated to the range of T)
+	*/
+	template <typename T>
+	inline void clampImage(cv::Mat& image, double min, double max) {
+		T low = cv::saturate_cast<T>(min), high = cv::saturate_cast<T>(max);
+		int count = image.cols * image.channels();
+
+		parallelRows(image.rows, 0, [&](const RowBand& band) {
+			for (int y = band.rowBegin; y < band.rowEnd; y++)
+				clampRow(image.ptr<T>(y), count, low, high);
+		}, 16);
+	}
+
+	/*! Clamp pixel values to be within [min, max].
+	*
+	* All values < min will be set to min, all values > max will be set to max, NaN stays NaN.
+	* Rows are clamped in parallel by SIMD min/max instructions (SSE2/AVX2 if available).
+	*
+	* \param image Image with pixels to clamp (any depth and number of channels)
+	* \param min Minimum value
+	* \param max Maximum value
+	*/
+	inline void clamp(cv::Mat& image, double min, double max) {
+		switch (image.depth()) {
+		case CV_8U:
+			clampImage<uchar>(image, min, max);
+			break;
+		case CV_8S:
+			clampImage<schar>(image, min, max);
+			break;
+		case CV_16U:
+			clampImage<ushort>(image, min, max);
+			break;
+		case CV_16S:
+			clampImage<short>(image, min, max);
+			break;
+		case CV_32S:
+			clampImage<int>(image, min, max);
+			break;
+		case CV_32F:
+			clampImage<float>(image, min, max);
+			break;
+		case CV_64F:
+			clampImage<double>(image, min, max);
+			break;
+		default:
+			std::cout << "[WARNING] Pixel type not supported in clamp()" << std::endl;
+		}
+	}
+
+	/*! Convert an image of type Src to type Dst with scaling, absolute value and clamping in one pass.
+	*
+	* \param source [in] Source image
+	* \param dst [out] Destination image (allocated with depth of Dst)
+	* \param alpha [in] Scale
+	* \param beta [in] Offset
+	* \param min [in] Lower bound
+	* \param max [in] Upper bound
+	* \param isAbsolute [in] Take the absolute value before clamping, if true
+	*/
+	template <typename Src, typename Dst>
+	inline void convertClampImage(const cv::Mat& source, cv::Mat& dst, double alpha, double beta, double min, double max, bool isAbsolute) {
+		float low = (float)std::max(min, (double)std::numeric_limits<Dst>::lowest());
+		float high = (float)std::min(max, (double)std::numeric_limits<Dst>::max());
+		int count = source.cols * source.channels();
+
+		parallelRows(source.rows, 0, [&](const RowBand& band) {
+			for (int y = band.rowBegin; y < band.rowEnd; y++)
+				convertClampRow(source.ptr<Src>(y), dst.ptr<Dst>(y), count, (float)alpha, (float)beta, low, high, isAbsolute);
+		}, 16);
+	}
+
+	/*! Select destination type of convertClamp(). */
+	template <typename Src>
+	inline void convertClampFrom(const cv::Mat& source, cv::Mat& dst, double alpha, double beta, double min, double max, bool isAbsolute) {
+		switch (dst.depth()) {
+		case CV_8U:
+			convertClampImage<Src, uchar>(source, dst, alpha, beta, min, max, isAbsolute);
+			break;
+		case CV_8S:
+			convertClampImage<Src, schar>(source, dst, alpha, beta, min, max, isAbsolute);
+			break;
+		case CV_16U:
+			convertClampImage<Src, ushort>(source, dst, alpha, beta, min, max, isAbsolute);
+			break;
+		case CV_16S:
+			convertClampImage<Src, short>(source, dst, alpha, beta, min, max, isAbsolute);
+			break;
+		default:
+			convertClampImage<Src, float>(source, dst, alpha, beta, min, max, isAbsolute);
+		}
+	}
+
+	/*! Convert an image to another depth, dst = clamp(alpha * src + beta, min, max), in a single pass.
+	*
+	* Replaces sequences like cv::abs(), convertTo() and scaling by a single pass over the image
+	* (e. g., |gradient| * 2 as 8-bit image). Results are additionally saturated to the range of
+	* the destination depth. Supported depths are CV_8U, CV_8S, CV_16U, CV_16S and CV_32F.
+	*
+	* \param src Source image (any number of channels)
+	* \param dst Destination image (may be the source image)
+	* \param depth Depth of the destination image
+	* \param alpha Scale
+	* \param beta Offset
+	* \param min Lower bound
+	* \param max Upper bound
+	* \param isAbsolute Take the absolute value |alpha * src + beta| before clamping, if true
+	*/
+	inline void convertClamp(const cv::Mat& src, cv::Mat& dst, int depth, double alpha = 1.0, double beta = 0.0,
+		double min = -DBL_MAX, double max = DBL_MAX, bool isAbsolute = false) {
+		const int depths[] = { CV_8U, CV_8S, CV_16U, CV_16S, CV_32F };
+
+		if ((std::find(std::begin(depths), std::end(depths), src.depth()) == std::end(depths)) ||
+			(std::find(std::begin(depths), std::end(depths), depth) == std::end(depths))) {
+			std::cout << "[WARNING] Depth not supported in convertClamp()" << std::endl;
+			return;
+		}
+
+		// Keep source data, if the destination is reallocated (e. g., in-place conversion to another depth)
+		cv::Mat source = src;
+		dst.create(source.rows, source.cols, CV_MAKETYPE(depth, source.channels()));
+
+		switch (source.depth()) {
+		case CV_8U:
+			convertClampFrom<uchar>(source, dst, alpha, beta, min, max, isAbsolute);
+			break;
+		case CV_8S:
+			convertClampFrom<schar>(source, dst, alpha, beta, min, max, isAbsolute);
+			break;
+		case CV_16U:
+			convertClampFrom<ushort>(source, dst, alpha, beta, min, max, isAbsolute);
+			break;
+		case CV_16S:
+			convertClampFrom<short>(source, dst, alpha, beta, min, max, isAbsolute);
+			break;
+		default:
+			convertClampFrom<float>(source, dst, alpha, beta, min, max, isAbsolute);
+		}
+	}
+}
+
+#endif /* IP_CLAMP_H */
@@ -0,0 +1,91 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Include files */
+#include <iostream>
+#include <map>
+#include <mutex>
+#include "EdgeList.h"
+#include "Parallel.h"
+#include "SimdKernels.h"
+
+/* Namespaces */
+using namespace std;
+
+namespace ip
+{
+	/*! Remove all edge pixels (keeps the allocated memory). */
+	void EdgeList::clear() {
+		x.clear();
+		y.clear();
+		direction.clear();
+	}
+
+	/*! Append the edge pixels of another list (e. g., of the next band of rows).
+	*
+	* \param other List to append (with directions, if this list has directions)
+	*/
+	void EdgeList::append(const EdgeList& other) {
+		x.insert(x.end(), other.x.begin(), other.x.end());
+		y.insert(y.end(), other.y.begin(), other.y.end());
+		direction.insert(direction.end(), other.direction.begin(), other.direction.end());
+	}
+
+	/*! Collect the edge pixels of a binary edge image.
+	*
+	* Each row is compacted by SIMD compares and movemasks (nonZeroColumns()), so zero pixels
+	* cost a fraction of a compare. Bands of rows are compacted in parallel and appended in
+	* row order.
+	*
+	* \param edgeImage [in] Edge image (CV_8U, edge pixels nonzero)
+	* \param edges [out] Edge pixels in row order
+	* \param direction [in] Optional gradient direction image (CV_8U) of the same size
+	*/
+	void findEdgePixels(const cv::Mat& edgeImage, EdgeList& edges, const cv::Mat& direction) {
+		edges.clear();
+		edges.imageSize = edgeImage.size();
+
+		// Check image types
+		if (edgeImage.type() != CV_8U) {
+			cout << "[WARNING] Incorrect image type. CV_8U expected." << endl;
+			return;
+		}
+		bool isDirection = !direction.empty();
+		if (isDirection && ((direction.type() != CV_8U) || (direction.size() != edgeImage.size()))) {
+			cout << "[WARNING] Direction image (CV_8U) of edge image size expected." << endl;
+			isDirection = false;
+		}
+
+		// Compact bands in parallel (band lists sorted by first row)
+		map<int, EdgeList> bandLists;
+		mutex bandMutex;
+
+		parallelRows(edgeImage.rows, 0, [&](const RowBand& band) {
+			EdgeList bandEdges;
+			vector<int> columns(edgeImage.cols);
+
+			for (int y = band.rowBegin; y < band.rowEnd; y++) {
+				int count = nonZeroColumns(edgeImage.ptr<uchar>(y), edgeImage.cols, columns.data());
+
+				bandEdges.x.insert(bandEdges.x.end(), columns.begin(), columns.begin() + count);
+				bandEdges.y.insert(bandEdges.y.end(), count, y);
+				if (isDirection) {
+					const uchar* directionRow = direction.ptr<uchar>(y);
+
+					for (int i = 0; i < count; i++)
+						bandEdges.direction.push_back(directionRow[columns[i]]);
+				}
+			}
+
+			lock_guard<mutex> lock(bandMutex);
+			bandLists[band.rowBegin] = move(bandEdges);
+		});
+
+		for (const auto& bandList : bandLists)
+			edges.append(bandList.second);
+	}
+}
@@ -0,0 +1,40 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_EDGE_LIST_H
+#define IP_EDGE_LIST_H
+
+/* Include files */
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+namespace ip
+{
+	/*! Edge pixels of an image as structure of arrays.
+	*
+	* Stages after edge detection (e. g., the Hough transform) run through the list instead of
+	* scanning all pixels of the edge image, which are mostly zero. Pixels are stored in row
+	* order. The gradient direction is optional (empty if not provided by the edge stage).
+	*/
+	struct EdgeList {
+		std::vector<int> x, y;				// Pixel locations
+		std::vector<uchar> direction;		// Gradient directions in 1/256 turn (see sobelFilter())
+		cv::Size imageSize;					// Size of the edge image
+
+		size_t size() const { return x.size(); }
+		bool empty() const { return x.empty(); }
+		bool hasDirection() const { return !direction.empty(); }
+		void clear();
+		void append(const EdgeList& other);
+	};
+
+	/* Prototypes */
+	void findEdgePixels(const cv::Mat& edgeImage, EdgeList& edges, const cv::Mat& direction = cv::Mat());
+}
+
+#endif /* IP_EDGE_LIST_H */
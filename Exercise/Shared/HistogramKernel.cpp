@@ -0,0 +1,325 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Include files */
+#include <cstdint>						// Declare uint32_t, uint64_t
+#include <cstring>						// Declare memcpy()
+#include <iostream>
+#include <mutex>
+#include "HistogramKernel.h"
+#include "Parallel.h"
+
+/* Namespaces */
+using namespace std;
+
+namespace ip
+{
+	/*! Count pixel values of image rows into interleaved sub-histograms.
+	*
+	* Runs of equal pixel values (low-entropy images) increment the same bin again and again.
+	* With a single histogram each increment has to wait for the store of the previous one
+	* (store-to-load forwarding). Consecutive pixels are counted into different sub-histograms
+	* instead, so the increments are independent. Pixels are loaded 8 at a time.
+	*
+	* \param image [in] Image (8-bit grayscale)
+	* \param rowBegin [in] First row to count
+	* \param rowEnd [in] Row behind the last row to count
+	* \param subHistograms [in,out] Sub-histograms to count into
+	*/
+	static void countRows(const cv::Mat& image, int rowBegin, int rowEnd, uint32_t subHistograms[HISTOGRAM_SUB_HISTOGRAMS][HISTOGRAM_BINS]) {
+		for (int y = rowBegin; y < rowEnd; y++) {
+			const uchar* data = image.ptr<uchar>(y);
+			int x = 0;
+
+			for (; x <= image.cols - 8; x += 8) {
+				uint64_t pixels;
+				memcpy(&pixels, data + x, sizeof(pixels));
+
+				for (int i = 0; i < 8; i++)
+					subHistograms[i % HISTOGRAM_SUB_HISTOGRAMS][(pixels >> (8 * i)) & 0xFF]++;
+			}
+			for (; x < image.cols; x++)
+				subHistograms[x % HISTOGRAM_SUB_HISTOGRAMS][data[x]]++;
+		}
+	}
+
+	/*! Add the pixel values of an image to a histogram.
+	*
+	* Horizontal bands of (sampled) rows are counted in parallel, each into its own interleaved
+	* sub-histograms. Sub-histograms are merged per band, band histograms are added up.
+	*
+	* \param image [in] Image (8-bit grayscale)
+	* \param mask [in] Pixels to count (mask value not 0, size of image) or empty for all pixels
+	* \param stride [in] Count every stride-th pixel of every stride-th row
+	* \param histogram [in,out] Histogram to add counts to
+	*/
+	static void addToHistogram(const cv::Mat& image, const cv::Mat& mask, int stride, unsigned histogram[HISTOGRAM_BINS]) {
+		mutex histogramMutex;
+		int sampledRows = (image.rows + stride - 1) / stride;
+
+		parallelRows(sampledRows, 0, [&](const RowBand& band) {
+			uint32_t subHistograms[HISTOGRAM_SUB_HISTOGRAMS][HISTOGRAM_BINS] = { { 0 } };
+
+			if ((stride == 1) && mask.empty())
+				countRows(image, band.rowBegin, band.rowEnd, subHistograms);
+			else {
+				for (int i = band.rowBegin; i < band.rowEnd; i++) {
+					const uchar* data = image.ptr<uchar>(i * stride);
+					const uchar* maskRow = mask.empty() ? NULL : mask.ptr<uchar>(i * stride);
+					int n = 0;
+
+					for (int x = 0; x < image.cols; x += stride) {
+						if ((maskRow == NULL) || (maskRow[x] != 0))
+							subHistograms[(n++) % HISTOGRAM_SUB_HISTOGRAMS][data[x]]++;
+					}
+				}
+			}
+
+			lock_guard<mutex> lock(histogramMutex);
+			for (int s = 0; s < HISTOGRAM_SUB_HISTOGRAMS; s++) {
+				for (int i = 0; i < HISTOGRAM_BINS; i++)
+					histogram[i] += subHistograms[s][i];
+			}
+		}, 16);
+	}
+
+	/*! Calculate the histogram (and cumulative histogram) of an 8-bit grayscale image.
+	*
+	* \param image [in] Image to calculate histogram for (8-bit grayscale)
+	* \param histogram [out] Histogram
+	* \param cumulative [out] Cumulative histogram (optional)
+	*/
+	void countHistogram(const cv::Mat& image, unsigned histogram[HISTOGRAM_BINS], unsigned cumulative[HISTOGRAM_BINS]) {
+		for (int i = 0; i < HISTOGRAM_BINS; i++)
+			histogram[i] = 0;
+
+		addToHistogram(image, cv::Mat(), 1, histogram);
+
+		if (cumulative != NULL)
+			cumulateHistogram(histogram, cumulative);
+	}
+
+	/*! Calculate a sampled histogram of an 8-bit grayscale image, optionally restricted by a mask.
+	*
+	* Only every stride-th pixel of every stride-th row is counted, i. e., stride^2 times fewer
+	* pixels (stride 4: 1/16). This is sufficient for statistics like thresholds or the dynamic range.
+	*
+	* \param image [in] Image to calculate histogram for (8-bit grayscale)
+	* \param histogram [out] Histogram (of sampled pixels)
+	* \param stride [in] Sampling stride in x and y (1: all pixels)
+	* \param mask [in] Pixels to count (mask value not 0, CV_8U with size of image) or empty for all pixels
+	*/
+	void countHistogram(const cv::Mat& image, unsigned histogram[HISTOGRAM_BINS], int stride, const cv::Mat& mask) {
+		for (int i = 0; i < HISTOGRAM_BINS; i++)
+			histogram[i] = 0;
+
+		if (!mask.empty() && ((mask.type() != CV_8U) || (mask.size() != image.size()))) {
+			cout << "[WARNING] Mask of type CV_8U with size of image expected. Mask ignored." << endl;
+			addToHistogram(image, cv::Mat(), max(stride, 1), histogram);
+		}
+		else
+			addToHistogram(image, mask, max(stride, 1), histogram);
+	}
+
+	/*! Calculate a sampled histogram of regions of interest of an 8-bit grayscale image.
+	*
+	* ROIs are clipped to the image. Pixels of overlapping ROIs are counted repeatedly.
+	*
+	* \param image [in] Image to calculate histogram for (8-bit grayscale)
+	* \param histogram [out] Histogram (of sampled pixels)
+	* \param stride [in] Sampling stride in x and y (1: all pixels), relative to the upper left ROI corner
+	* \param rois [in] Regions of interest
+	*/
+	void countHistogram(const cv::Mat& image, unsigned histogram[HISTOGRAM_BINS], int stride, const vector<cv::Rect>& rois) {
+		cv::Rect imageRect(0, 0, image.cols, image.rows);
+
+		for (int i = 0; i < HISTOGRAM_BINS; i++)
+			histogram[i] = 0;
+
+		for (const cv::Rect& roi : rois) {
+			cv::Rect clipped = roi & imageRect;
+
+			if (clipped.area() > 0)
+				addToHistogram(image(clipped), cv::Mat(), max(stride, 1), histogram);
+		}
+	}
+
+	/*! Smooth histogram exponentially with the histogram of the previous frame.
+	*
+	* histogram = weight * histogram + (1 - weight) * previous
+	*
+	* Both histograms must be based on the same number of pixels. An empty previous histogram
+	* (all bins 0, e. g., first frame) leaves the histogram unchanged.
+	*
+	* \param histogram [in,out] Histogram of the current frame
+	* \param previous [in] (Smoothed) histogram of the previous frame
+	* \param weight [in] Weight of the current frame in [0.0, 1.0]
+	*/
+	void smoothHistogram(unsigned histogram[HISTOGRAM_BINS], const unsigned previous[HISTOGRAM_BINS], double weight) {
+		bool isPreviousEmpty = true;
+
+		for (int i = 0; (i < HISTOGRAM_BINS) && isPreviousEmpty; i++)
+			isPreviousEmpty = (previous[i] == 0);
+		if (isPreviousEmpty)
+			return;
+
+		for (int i = 0; i < HISTOGRAM_BINS; i++)
+			histogram[i] = (unsigned)(weight * histogram[i] + (1.0 - weight) * previous[i] + 0.5);
+	}
+
+	/*! Calculate cumulative histogram.
+	*
+	* \param histogram [in] Histogram
+	* \param cumulative [out] Cumulative histogram (may be the histogram itself)
+	*/
+	void cumulateHistogram(const unsigned histogram[HISTOGRAM_BINS], unsigned cumulative[HISTOGRAM_BINS]) {
+		unsigned sum = 0;
+
+		for (int i = 0; i < HISTOGRAM_BINS; i++) {
+			sum += histogram[i];
+			cumulative[i] = sum;
+		}
+	}
+
+	/*! Luma of a BGR pixel (ITU-R BT.601 weights 0.114, 0.587, 0.299 in 8-bit fixed point).
+	*
+	* \param pixel [in] Blue, green and red value
+	* \return luma in the value range of the channels
+	*/
+	template <typename T>
+	static inline unsigned luma(const T* pixel) {
+		return (29u * pixel[0] + 150u * pixel[1] + 77u * pixel[2] + 128u) >> 8;
+	}
+
+	/*! Count one channel (or the luma) of image rows into interleaved sub-histograms.
+	*
+	* \param image [in] Image (8 or 16 bit, one or more channels)
+	* \param channel [in] Channel to count or HISTOGRAM_LUMA
+	* \param shift [in] Values are shifted right by shift bits to get the bin
+	* \param bins [in] Number of bins (larger bins count into the last bin)
+	* \param rowBegin [in] First row to count
+	* \param rowEnd [in] Row behind the last row to count
+	* \param subHistograms [in,out] numSubHistograms consecutive histograms of bins elements
+	* \param numSubHistograms [in] Number of sub-histograms
+	*/
+	template <typename T>
+	static void countRowsGeneric(const cv::Mat& image, int channel, int shift, int bins, int rowBegin, int rowEnd, uint32_t* subHistograms, int numSubHistograms) {
+		int channels = image.channels();
+		unsigned lastBin = (unsigned)bins - 1;
+
+		for (int y = rowBegin; y < rowEnd; y++) {
+			const T* data = image.ptr<T>(y);
+
+			for (int x = 0; x < image.cols; x++) {
+				const T* pixel = data + (size_t)x * channels;
+				unsigned bin = ((channel == HISTOGRAM_LUMA) ? luma(pixel) : (unsigned)pixel[channel]) >> shift;
+
+				subHistograms[(size_t)(x % numSubHistograms) * bins + ((bin < lastBin) ? bin : lastBin)]++;
+			}
+		}
+	}
+
+	/*! Calculate the histogram of one channel (or the luma) of an 8-bit or 16-bit image.
+	*
+	* Supports, e. g., BGR images (per channel or luma) and 16-bit camera images with 10 or
+	* 12 significant bits (Mono10, Mono12). The value range [0, 2^bits) is divided into bins of
+	* equal width, values above the range count into the last bin. Histograms of up to 4096 bins
+	* use interleaved sub-histograms like the 8-bit grayscale path, larger histograms (up to
+	* 65536 bins, one bin per 16-bit value) a single histogram per band of rows.
+	*
+	* \param image [in] Image (depth CV_8U or CV_16U, any number of channels)
+	* \param histogram [out] Histogram with bins elements
+	* \param channel [in] Channel index or HISTOGRAM_LUMA (luma of BGR, value of single-channel images)
+	* \param bins [in] Number of bins (power of 2, at most 2^bits)
+	* \param bits [in] Significant bits of the pixel values (0: 8 or 16 by image depth)
+	*/
+	void countHistogram(const cv::Mat& image, vector<unsigned>& histogram, int channel, int bins, int bits) {
+		int depthBits = (image.depth() == CV_16U) ? 16 : 8;
+		int channels = image.channels();
+
+		histogram.assign((bins > 0) ? bins : 1, 0);
+
+		// Assert correct parameters
+		if ((image.depth() != CV_8U) && (image.depth() != CV_16U)) {
+			cout << "[WARNING] Incorrect image depth. CV_8U or CV_16U expected." << endl;
+			return;
+		}
+		if (bits == 0)
+			bits = depthBits;
+		if ((bits < 1) || (bits > depthBits) || (bins < 1) || (bins > (1 << bits)) || ((bins & (bins - 1)) != 0)) {
+			cout << "[WARNING] Number of bins must be a power of 2 within [1, 2^bits], bits within [1, " << depthBits << "]." << endl;
+			return;
+		}
+		if ((channel == HISTOGRAM_LUMA) && (channels == 1))
+			channel = 0;
+		if (((channel == HISTOGRAM_LUMA) && (channels < 3)) || (channel < HISTOGRAM_LUMA) || (channel >= channels)) {
+			cout << "[WARNING] Channel not available in image (luma requires BGR)." << endl;
+			return;
+		}
+
+		// 8-bit grayscale with 256 bins
+		if ((image.type() == CV_8U) && (bins == HISTOGRAM_BINS) && (bits == 8)) {
+			addToHistogram(image, cv::Mat(), 1, histogram.data());
+			return;
+		}
+
+		int shift = 0;
+		while ((bins << shift) < (1 << bits))
+			shift++;
+
+		mutex histogramMutex;
+		int numSubHistograms = (bins <= HISTOGRAM_MAX_SUB_BINS) ? HISTOGRAM_SUB_HISTOGRAMS : 1;
+
+		parallelRows(image.rows, 0, [&](const RowBand& band) {
+			vector<uint32_t> subHistograms((size_t)numSubHistograms * bins, 0);
+
+			if (image.depth() == CV_16U)
+				countRowsGeneric<ushort>(image, channel, shift, bins, band.rowBegin, band.rowEnd, subHistograms.data(), numSubHistograms);
+			else
+				countRowsGeneric<uchar>(image, channel, shift, bins, band.rowBegin, band.rowEnd, subHistograms.data(), numSubHistograms);
+
+			lock_guard<mutex> lock(histogramMutex);
+			for (int s = 0; s < numSubHistograms; s++) {
+				for (int i = 0; i < bins; i++)
+					histogram[i] += subHistograms[(size_t)s * bins + i];
+			}
+		}, (bins <= HISTOGRAM_MAX_SUB_BINS) ? 16 : 256);
+	}
+
+	/*! Calculate cumulative histogram.
+	*
+	* \param histogram [in] Histogram
+	* \param cumulative [out] Cumulative histogram (may be the histogram itself)
+	*/
+	void cumulateHistogram(const vector<unsigned>& histogram, vector<unsigned>& cumulative) {
+		unsigned sum = 0;
+
+		cumulative.resize(histogram.size());
+		for (size_t i = 0; i < histogram.size(); i++) {
+			sum += histogram[i];
+			cumulative[i] = sum;
+		}
+	}
+
+	/*! Compact a histogram to its occupied bins (e. g., 65536-bin histograms of 12-bit images).
+	*
+	* \param histogram [in] Histogram
+	* \param values [out] Bins with at least one pixel (ascending)
+	* \param counts [out] Number of pixels per bin in values
+	*/
+	void sparseHistogram(const vector<unsigned>& histogram, vector<int>& values, vector<unsigned>& counts) {
+		values.clear();
+		counts.clear();
+
+		for (size_t i = 0; i < histogram.size(); i++) {
+			if (histogram[i] != 0) {
+				values.push_back((int)i);
+				counts.push_back(histogram[i]);
+			}
+		}
+	}
+}
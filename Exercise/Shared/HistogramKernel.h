@@ -0,0 +1,35 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_HISTOGRAM_KERNEL_H
+#define IP_HISTOGRAM_KERNEL_H
+
+/* Include files */
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+/* Defines */
+#define HISTOGRAM_BINS 256
+#define HISTOGRAM_SUB_HISTOGRAMS 4		// Interleaved sub-histograms per thread (consecutive pixels count into different arrays)
+#define HISTOGRAM_MAX_SUB_BINS 4096		// Larger histograms (e. g., 65536 bins) use a single histogram per thread
+#define HISTOGRAM_LUMA -1				// Channel index selecting the luma of BGR pixels
+
+namespace ip
+{
+	void countHistogram(const cv::Mat& image, unsigned histogram[HISTOGRAM_BINS], unsigned cumulative[HISTOGRAM_BINS] = NULL);
+	void countHistogram(const cv::Mat& image, unsigned histogram[HISTOGRAM_BINS], int stride, const cv::Mat& mask = cv::Mat());
+	void countHistogram(const cv::Mat& image, unsigned histogram[HISTOGRAM_BINS], int stride, const std::vector<cv::Rect>& rois);
+	void smoothHistogram(unsigned histogram[HISTOGRAM_BINS], const unsigned previous[HISTOGRAM_BINS], double weight);
+	void cumulateHistogram(const unsigned histogram[HISTOGRAM_BINS], unsigned cumulative[HISTOGRAM_BINS]);
+
+	void countHistogram(const cv::Mat& image, std::vector<unsigned>& histogram, int channel, int bins = HISTOGRAM_BINS, int bits = 0);
+	void cumulateHistogram(const std::vector<unsigned>& histogram, std::vector<unsigned>& cumulative);
+	void sparseHistogram(const std::vector<unsigned>& histogram, std::vector<int>& values, std::vector<unsigned>& counts);
+}
+
+#endif /* IP_HISTOGRAM_KERNEL_H */
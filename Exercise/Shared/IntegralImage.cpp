@@ -0,0 +1,115 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Include files */
+#include <iostream>
+#include "IntegralImage.h"
+
+/* Namespaces */
+using namespace std;
+
+namespace ip
+{
+	/*! Accumulate integral image tables.
+	*
+	* Each table entry I(x+1, y+1) holds the sum over all pixels (u, v) with u <= x and v <= y.
+	*
+	* \param image [in] Image to integrate (type CV_8U)
+	* \param sums [out] Table of size (cols + 1) x (rows + 1) for sums of pixel values
+	* \param squares [out] Table of same size for sums of squared values (or NULL)
+	*/
+	template <typename SumType, typename SquaresType>
+	static void accumulate(const cv::Mat& image, SumType* sums, SquaresType* squares) {
+		size_t stride = (size_t)image.cols + 1;
+
+		// First row is zero
+		for (size_t x = 0; x < stride; x++) {
+			sums[x] = 0;
+			if (squares != NULL)
+				squares[x] = 0;
+		}
+
+		// Run through image rows adding running row sums to the row above
+		for (int y = 0; y < image.rows; y++) {
+			const uchar* srcRow = image.ptr<uchar>(y);
+			const SumType* sumsAbove = sums + (size_t)y * stride;
+			SumType* sumsRow = sums + (size_t)(y + 1) * stride;
+			SumType rowSum = 0;
+
+			sumsRow[0] = 0;
+			for (int x = 0; x < image.cols; x++) {
+				rowSum += srcRow[x];
+				sumsRow[x + 1] = sumsAbove[x + 1] + rowSum;
+			}
+
+			if (squares != NULL) {
+				const SquaresType* squaresAbove = squares + (size_t)y * stride;
+				SquaresType* squaresRow = squares + (size_t)(y + 1) * stride;
+				SquaresType rowSquares = 0;
+
+				squaresRow[0] = 0;
+				for (int x = 0; x < image.cols; x++) {
+					rowSquares += (SquaresType)srcRow[x] * srcRow[x];
+					squaresRow[x + 1] = squaresAbove[x + 1] + rowSquares;
+				}
+			}
+		}
+	}
+
+	/*! Create integral image.
+	*
+	* \param image [in] Image to integrate (type CV_8U)
+	* \param isSquares [in] Also integrate squared pixel values, if true
+	*/
+	IntegralImage::IntegralImage(const cv::Mat& image, bool isSquares) {
+		compute(image, isSquares);
+	}
+
+	/*! (Re-)compute integral image for an image.
+	*
+	* Memory is reused when called repeatedly for images of the same size (e. g., video frames).
+	*
+	* \param image [in] Image to integrate (type CV_8U)
+	* \param isSquares [in] Also integrate squared pixel values, if true
+	*/
+	void IntegralImage::compute(const cv::Mat& image, bool isSquares) {
+		// Check for correct image type (8-bit grayscale)
+		if (image.type() != CV_8U) {
+			cout << "[WARNING] Incorrect image type. CV_8U expected." << endl;
+			rows = cols = 0;
+			return;
+		}
+
+		// Select accumulator sizes by maximum possible sums
+		uint64_t numberPixels = (uint64_t)image.rows * image.cols;
+		size_t tableSize = ((size_t)image.rows + 1) * ((size_t)image.cols + 1);
+
+		rows = image.rows;
+		cols = image.cols;
+		this->isSquares = isSquares;
+		isSum64 = (numberPixels * 255 > UINT32_MAX);
+		isSquares64 = (numberPixels * 255 * 255 > UINT32_MAX);
+
+		// Allocate tables and accumulate
+		if (isSum64)
+			sum64.resize(tableSize);
+		else
+			sum32.resize(tableSize);
+
+		if (isSquares && isSquares64)
+			squares64.resize(tableSize);
+		else if (isSquares)
+			squares32.resize(tableSize);
+
+		if (isSum64)
+			accumulate<uint64_t, uint64_t>(image, sum64.data(), isSquares ? squares64.data() : NULL);
+		else if (isSquares64)
+			accumulate<uint32_t, uint64_t>(image, sum32.data(), isSquares ? squares64.data() : NULL);
+		else
+			accumulate<uint32_t, uint32_t>(image, sum32.data(), isSquares ? squares32.data() : NULL);
+	}
+}
@@ -0,0 +1,93 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_INTEGRAL_IMAGE_H
+#define IP_INTEGRAL_IMAGE_H
+
+/* Include files */
+#include <cstdint>						// Declare uint32_t, uint64_t
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+namespace ip
+{
+	/*! Integral image (summed-area table) of an 8-bit grayscale image.
+	*
+	* Sums and sums of squared pixel values inside any rectangle are available in O(1).
+	* The integral image is intended to be built once per frame and then to be shared by
+	* all operations processing this frame (e. g., box filter, thresholding, template matching).
+	*
+	* The tables have one additional leading row and column of zeros. Accumulators are 32 bit,
+	* if the sum over the entire image fits into 32 bit, and 64 bit otherwise. As rectangle sums
+	* are differences, unsigned wrap-around of intermediate table values cancels out.
+	*/
+	class IntegralImage {
+	public:
+		IntegralImage() {}
+		IntegralImage(const cv::Mat& image, bool isSquares = true);
+		void compute(const cv::Mat& image, bool isSquares = true);
+
+		bool empty() const { return (rows == 0) || (cols == 0); }
+		bool hasSquares() const { return isSquares; }
+		cv::Size size() const { return cv::Size(cols, rows); }
+
+		inline uint64_t sum(int x, int y, int width, int height) const;
+		inline uint64_t sum(const cv::Rect& rect) const { return sum(rect.x, rect.y, rect.width, rect.height); }
+		inline uint64_t squaredSum(int x, int y, int width, int height) const;
+		inline uint64_t squaredSum(const cv::Rect& rect) const { return squaredSum(rect.x, rect.y, rect.width, rect.height); }
+
+	private:
+		int rows = 0, cols = 0;
+		bool isSquares = false;
+		bool isSum64 = false, isSquares64 = false;
+		std::vector<uint32_t> sum32, squares32;
+		std::vector<uint64_t> sum64, squares64;
+	};
+
+	/*! Sum of pixel values inside a rectangle.
+	*
+	* \param x Left column of the rectangle (must be inside the image)
+	* \param y Top row of the rectangle (must be inside the image)
+	* \param width Rectangle width (x + width <= image width)
+	* \param height Rectangle height (y + height <= image height)
+	* \return sum of pixel values g(x,y) inside the rectangle
+	*/
+	inline uint64_t IntegralImage::sum(int x, int y, int width, int height) const {
+		size_t stride = (size_t)cols + 1;
+		size_t upper = (size_t)y * stride + x;
+		size_t lower = (size_t)(y + height) * stride + x;
+
+		if (isSum64)
+			return sum64[lower + width] - sum64[lower] - sum64[upper + width] + sum64[upper];
+		else
+			return (uint32_t)(sum32[lower + width] - sum32[lower] - sum32[upper + width] + sum32[upper]);
+	}
+
+	/*! Sum of squared pixel values inside a rectangle.
+	*
+	* Requires the integral image to be computed with squares.
+	*
+	* \param x Left column of the rectangle (must be inside the image)
+	* \param y Top row of the rectangle (must be inside the image)
+	* \param width Rectangle width (x + width <= image width)
+	* \param height Rectangle height (y + height <= image height)
+	* \return sum of squared pixel values g(x,y)^2 inside the rectangle
+	*/
+	inline uint64_t IntegralImage::squaredSum(int x, int y, int width, int height) const {
+		size_t stride = (size_t)cols + 1;
+		size_t upper = (size_t)y * stride + x;
+		size_t lower = (size_t)(y + height) * stride + x;
+
+		if (isSquares64)
+			return squares64[lower + width] - squares64[lower] - squares64[upper + width] + squares64[upper];
+		else
+			return (uint32_t)(squares32[lower + width] - squares32[lower] - squares32[upper + width] + squares32[upper]);
+	}
+}
+
+#endif /* IP_INTEGRAL_IMAGE_H */
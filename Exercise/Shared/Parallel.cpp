@@ -0,0 +1,268 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Include files */
+#include <algorithm>
+#include "Parallel.h"
+
+/* Defines */
+#define PARALLEL_BANDS_PER_THREAD 4		// Bands per thread, more bands balance unequal costs better
+
+/* Namespaces */
+using namespace std;
+
+namespace ip
+{
+	/*! Index of the calling thread within the thread pool (0 for threads not owned by the pool). */
+	static thread_local int currentThreadIndex = 0;
+
+	/*! True while the calling thread executes a task (nested tasks run serially). */
+	static thread_local bool isInsideTask = false;
+
+	/*! Create thread pool.
+	*
+	* \param numThreads Number of threads including the calling thread (at least 1)
+	*/
+	ThreadPool::ThreadPool(int numThreads) {
+		numThreads = max(numThreads, 1);
+
+		for (int slot = 0; slot < numThreads; slot++)
+			queues.push_back(make_unique<TaskQueue>());
+		for (int slot = 1; slot < numThreads; slot++)
+			workers.emplace_back(&ThreadPool::workerLoop, this, slot);
+	}
+
+	/*! Stop and join worker threads. */
+	ThreadPool::~ThreadPool() {
+		{
+			lock_guard<std::mutex> lock(mutex);
+			isStopping = true;
+		}
+		wakeCondition.notify_all();
+
+		for (thread& worker : workers)
+			worker.join();
+	}
+
+	/*! Run tasks 0 .. numTasks - 1 and wait for their completion.
+	*
+	* The calling thread takes part in processing the tasks. Calls from several threads are
+	* serialized, also for single tasks, as all threads not owned by the pool have thread index 0.
+	*
+	* \param numTasks Number of tasks
+	* \param task Function called with the task index
+	*/
+	void ThreadPool::run(int numTasks, const function<void(int)>& task) {
+		if (numTasks <= 0)
+			return;
+
+		// Hold the pool unless called from within a task (the outer run() holds it). The lock is
+		// recursive, as a single task runs on the calling thread and may start tasks itself.
+		unique_lock<std::recursive_mutex> runLock(runMutex, defer_lock);
+
+		if (!workers.empty() && !isInsideTask)
+			runLock.lock();
+
+		// Run serially without workers, for single tasks, and for tasks started from within a task
+		if (workers.empty() || (numTasks == 1) || isInsideTask) {
+			for (int i = 0; i < numTasks; i++)
+				task(i);
+			return;
+		}
+
+		// Publish task before its indices become visible to other threads
+		{
+			lock_guard<std::mutex> lock(mutex);
+			currentTask = &task;
+			pendingTasks = numTasks;
+		}
+
+		// Distribute task indices in contiguous blocks (neighboring bands share cache lines)
+		int numQueues = size();
+
+		for (int slot = 0; slot < numQueues; slot++) {
+			lock_guard<std::mutex> lock(queues[slot]->mutex);
+
+			for (int i = slot * numTasks / numQueues; i < (slot + 1) * numTasks / numQueues; i++)
+				queues[slot]->indices.push_back(i);
+		}
+
+		// Wake workers and take part in processing
+		{
+			lock_guard<std::mutex> lock(mutex);
+			generation++;
+		}
+		wakeCondition.notify_all();
+		work(0);
+
+		// Wait for tasks processed by workers
+		unique_lock<std::mutex> lock(mutex);
+		doneCondition.wait(lock, [this] { return pendingTasks == 0; });
+		currentTask = nullptr;
+	}
+
+	/*! Get index of the calling thread.
+	*
+	* \return index in [0, size()), 0 for the thread calling run()
+	*/
+	int ThreadPool::threadIndex() {
+		return currentThreadIndex;
+	}
+
+	/*! Take a task index from the own queue or steal one from another queue.
+	*
+	* \param slot Queue of the calling thread
+	* \param index [out] Task index
+	* \return true if a task index was found
+	*/
+	bool ThreadPool::popTask(int slot, int& index) {
+		int numQueues = size();
+
+		// Own queue (back, most recently added index)
+		{
+			TaskQueue& queue = *queues[slot];
+			lock_guard<std::mutex> lock(queue.mutex);
+
+			if (!queue.indices.empty()) {
+				index = queue.indices.back();
+				queue.indices.pop_back();
+				return true;
+			}
+		}
+
+		// Other queues (front, the index the owner would take last)
+		for (int i = 1; i < numQueues; i++) {
+			TaskQueue& queue = *queues[(slot + i) % numQueues];
+			lock_guard<std::mutex> lock(queue.mutex);
+
+			if (!queue.indices.empty()) {
+				index = queue.indices.front();
+				queue.indices.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/*! Process tasks until all queues are empty.
+	*
+	* \param slot Queue of the calling thread
+	*/
+	void ThreadPool::work(int slot) {
+		int index;
+
+		isInsideTask = true;
+		while (popTask(slot, index)) {
+			(*currentTask)(index);
+
+			if (--pendingTasks == 0) {
+				lock_guard<std::mutex> lock(mutex);
+				doneCondition.notify_all();
+			}
+		}
+		isInsideTask = false;
+	}
+
+	/*! Main loop of a worker thread.
+	*
+	* \param slot Queue of the worker thread
+	*/
+	void ThreadPool::workerLoop(int slot) {
+		unsigned long long processedGeneration = 0;
+
+		currentThreadIndex = slot;
+		while (true) {
+			{
+				unique_lock<std::mutex> lock(mutex);
+				wakeCondition.wait(lock, [&] { return isStopping || (generation != processedGeneration); });
+
+				if (isStopping)
+					return;
+				processedGeneration = generation;
+			}
+			work(slot);
+		}
+	}
+
+	/*! Global thread pool (created on first use with one thread per core). */
+	static unique_ptr<ThreadPool>& globalPool() {
+		static unique_ptr<ThreadPool> pool = make_unique<ThreadPool>((int)thread::hardware_concurrency());
+		return pool;
+	}
+
+	/*! Get the number of threads used by parallel ip:: functions.
+	*
+	* \return number of threads including the calling thread
+	*/
+	int getNumThreads() {
+		return globalPool()->size();
+	}
+
+	/*! Set the number of threads used by parallel ip:: functions.
+	*
+	* Must not be called while parallel functions are running. 1 selects serial execution,
+	* e. g., to compare results and runtimes.
+	*
+	* \param numThreads Number of threads including the calling thread (0: one thread per core)
+	*/
+	void setNumThreads(int numThreads) {
+		if (numThreads <= 0)
+			numThreads = (int)thread::hardware_concurrency();
+
+		globalPool().reset();
+		globalPool() = make_unique<ThreadPool>(numThreads);
+	}
+
+	/*! Get index of the calling thread, e. g., to select per-thread partial results.
+	*
+	* \return index in [0, getNumThreads())
+	*/
+	int getThreadIndex() {
+		return ThreadPool::threadIndex();
+	}
+
+	/*! Call a function for the indices 0 .. count - 1 in parallel.
+	*
+	* \param count Number of indices
+	* \param body Function called with the index
+	*/
+	void parallelFor(int count, const function<void(int)>& body) {
+		globalPool()->run(count, body);
+	}
+
+	/*! Split a row-local operation into horizontal bands processed in parallel.
+	*
+	* Each band is passed with its halo rows (kernel radius above and below, clipped to the image),
+	* the body must only write the rows [rowBegin, rowEnd). Operations which prime state from
+	* the halo rows (e. g., running sums) should pass a minimum band height well above the halo.
+	*
+	* \param rows Number of rows to process
+	* \param halo Kernel radius (rows read above and below a band)
+	* \param body Function processing one band
+	* \param minBandHeight Minimum number of rows per band
+	*/
+	void parallelRows(int rows, int halo, const function<void(const RowBand&)>& body, int minBandHeight) {
+		if (rows <= 0)
+			return;
+
+		ThreadPool& pool = *globalPool();
+		int maxBands = (pool.size() > 1) ? pool.size() * PARALLEL_BANDS_PER_THREAD : 1;
+		int numBands = min(max(rows / max(minBandHeight, 1), 1), maxBands);
+		int bandHeight = (rows + numBands - 1) / numBands;
+
+		numBands = (rows + bandHeight - 1) / bandHeight;
+		pool.run(numBands, [&](int i) {
+			RowBand band;
+
+			band.rowBegin = i * bandHeight;
+			band.rowEnd = min(band.rowBegin + bandHeight, rows);
+			band.haloBegin = max(band.rowBegin - halo, 0);
+			band.haloEnd = min(band.rowEnd + halo, rows);
+			body(band);
+		});
+	}
+}
@@ -0,0 +1,81 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_PARALLEL_H
+#define IP_PARALLEL_H
+
+/* Include files */
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ip
+{
+	/*! Horizontal band of image rows processed by one task.
+	*
+	* Rows [rowBegin, rowEnd) are written by the task. Rows [haloBegin, haloEnd) additionally
+	* include the halo of kernel radius rows above and below (clipped to the image), i. e.,
+	* all source rows the task reads for a kernel of that radius.
+	*/
+	struct RowBand {
+		int rowBegin, rowEnd;
+		int haloBegin, haloEnd;
+	};
+
+	/*! Thread pool with work stealing.
+	*
+	* Every thread (including the calling thread) owns a queue of task indices. Threads take
+	* tasks from the back of their own queue and steal from the front of the other queues when
+	* their own queue runs empty, so bands of unequal cost are balanced automatically.
+	* Tasks started from within a task run serially on the calling thread. run() may be called
+	* from several threads, the calls are processed one after the other.
+	*/
+	class ThreadPool {
+	public:
+		explicit ThreadPool(int numThreads);
+		~ThreadPool();
+
+		int size() const { return (int)queues.size(); }
+		void run(int numTasks, const std::function<void(int)>& task);
+
+		static int threadIndex();
+
+	private:
+		struct TaskQueue {
+			std::mutex mutex;
+			std::deque<int> indices;
+		};
+
+		bool popTask(int slot, int& index);
+		void work(int slot);
+		void workerLoop(int slot);
+
+		std::vector<std::thread> workers;
+		std::vector<std::unique_ptr<TaskQueue>> queues;
+		const std::function<void(int)>* currentTask = nullptr;
+		std::atomic<int> pendingTasks{ 0 };
+		unsigned long long generation = 0;
+		bool isStopping = false;
+		std::mutex mutex;
+		std::recursive_mutex runMutex;
+		std::condition_variable wakeCondition, doneCondition;
+	};
+
+	int getNumThreads();
+	void setNumThreads(int numThreads);
+	int getThreadIndex();
+	void parallelFor(int count, const std::function<void(int)>& body);
+	void parallelRows(int rows, int halo, const std::function<void(const RowBand&)>& body, int minBandHeight = 1);
+}
+
+#endif /* IP_PARALLEL_H */
@@ -0,0 +1,546 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Compiler settings */
+#define _USE_MATH_DEFINES
+
+/* Include files */
+#include <algorithm>
+#include <climits>
+#include <cstring>						// Declare memcpy()
+#include <functional>
+#include <iostream>
+#include <math.h>
+#include <vector>
+#include "Clamp.h"
+#include "Parallel.h"
+#include "Patterns.h"
+
+/* Defines */
+#define PATTERNS_MIN_BAND_HEIGHT 16		// Minimum rows per parallel band
+#define PATTERNS_SINE_RESYNC 256		// Values per sine recurrence before sin() is evaluated again
+
+/* Namespaces */
+using namespace std;
+
+namespace ip
+{
+	namespace patterns
+	{
+		/*! Next value of a SplitMix64 random number generator.
+		*
+		* \param state [in,out] Generator state
+		* \return 64 random bits
+		*/
+		static inline uint64_t splitMix64(uint64_t& state) {
+			uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		/*! Initial generator state of an image row (independent of the band processing the row).
+		*
+		* \param seed [in] Seed of the pattern
+		* \param y [in] Row
+		* \return generator state
+		*/
+		static inline uint64_t rowState(uint64_t seed, int y) {
+			uint64_t state = seed ^ ((uint64_t)(y + 1) * 0xD1B54A32D192ED03ull);
+
+			splitMix64(state);
+			return state;
+		}
+
+		/*! Uniform random float in (0, 1] from the upper 24 bits. */
+		static inline float unitFloat(uint64_t bits) {
+			return (float)((bits >> 40) + 1) * (1.0f / 16777216.0f);
+		}
+
+		/*! Value range of an image depth.
+		*
+		* \param depth [in] Image depth
+		* \param low [out] Smallest value (0 for floating-point depths)
+		* \param high [out] Largest value (1 for floating-point depths)
+		*/
+		static void depthRange(int depth, double& low, double& high) {
+			switch (depth) {
+			case CV_8U:
+				low = 0, high = UCHAR_MAX;
+				break;
+			case CV_8S:
+				low = SCHAR_MIN, high = SCHAR_MAX;
+				break;
+			case CV_16U:
+				low = 0, high = USHRT_MAX;
+				break;
+			case CV_16S:
+				low = SHRT_MIN, high = SHRT_MAX;
+				break;
+			case CV_32S:
+				low = INT_MIN, high = INT_MAX;
+				break;
+			default:
+				low = 0, high = 1;
+			}
+		}
+
+		/*! Check if an image depth is supported by the patterns. */
+		static bool isSupported(int depth, const char* function) {
+			if (depth > CV_64F) {
+				cout << "[WARNING] Depth not supported in ip::patterns::" << function << "()" << endl;
+				return false;
+			}
+			return true;
+		}
+
+		/*! Fill a row by sin(start + x * step), x = 0 .. count - 1.
+		*
+		* The sine is advanced by rotation (two multiplications and additions per value) and
+		* evaluated exactly every PATTERNS_SINE_RESYNC values to keep rounding errors small.
+		*
+		* \param values [out] Sine values
+		* \param count [in] Number of values
+		* \param start [in] Phase of the first value
+		* \param step [in] Phase increment per value
+		* \param amplitude [in] Amplitude
+		* \param offset [in] Offset added to all values
+		*/
+		static void sineRow(float* values, int count, double start, double step, double amplitude, double offset) {
+			double stepSin = sin(step), stepCos = cos(step);
+
+			for (int x = 0; x < count; x += PATTERNS_SINE_RESYNC) {
+				double s = sin(start + x * step), c = cos(start + x * step);
+				int end = min(x + PATTERNS_SINE_RESYNC, count);
+
+				for (int i = x; i < end; i++) {
+					values[i] = (float)(offset + amplitude * s);
+
+					double next = s * stepCos + c * stepSin;
+					c = c * stepCos - s * stepSin;
+					s = next;
+				}
+			}
+		}
+
+		/*! Repeat the first cols values of a row for all channels (in place). */
+		static void expandChannels(float* values, int cols, int channels) {
+			if (channels == 1)
+				return;
+
+			for (int x = cols - 1; x >= 0; x--) {
+				for (int c = channels - 1; c >= 0; c--)
+					values[x * channels + c] = values[x];
+			}
+		}
+
+		/*! Store normalized values [0, 1] of a row in the value range of the image depth.
+		*
+		* \param values [in] Normalized values (cols * channels)
+		* \param image [in,out] Image
+		* \param y [in] Row to store
+		*/
+		static void storeRow(const float* values, cv::Mat& image, int y) {
+			int count = image.cols * image.channels();
+			double low, high;
+
+			depthRange(image.depth(), low, high);
+			float scale = (float)(high - low), offset = (float)low;
+
+			switch (image.depth()) {
+			case CV_8U:
+				convertClampRow(values, image.ptr<uchar>(y), count, scale, offset, (float)low, (float)high, false);
+				break;
+			case CV_8S:
+				convertClampRow(values, image.ptr<schar>(y), count, scale, offset, (float)low, (float)high, false);
+				break;
+			case CV_16U:
+				convertClampRow(values, image.ptr<ushort>(y), count, scale, offset, (float)low, (float)high, false);
+				break;
+			case CV_16S:
+				convertClampRow(values, image.ptr<short>(y), count, scale, offset, (float)low, (float)high, false);
+				break;
+			case CV_32S: {
+				int* row = image.ptr<int>(y);
+
+				for (int i = 0; i < count; i++)
+					row[i] = cv::saturate_cast<int>((double)values[i] * (high - low) + low);
+				break;
+			}
+			case CV_32F:
+				memcpy(image.ptr<float>(y), values, count * sizeof(float));
+				break;
+			default: {
+				double* row = image.ptr<double>(y);
+
+				for (int i = 0; i < count; i++)
+					row[i] = values[i];
+			}
+			}
+		}
+
+		/*! Generate an image row by row in parallel.
+		*
+		* \param image [out] Image (reallocated if size or type differ)
+		* \param size [in] Image size
+		* \param type [in] Image type
+		* \param generator [in] Function filling the normalized values [0, 1] of row y (one value per pixel)
+		*/
+		static void generate(cv::Mat& image, cv::Size size, int type, const function<void(int, float*)>& generator) {
+			image.create(size, type);
+
+			int channels = image.channels();
+			parallelRows(image.rows, 0, [&](const RowBand& band) {
+				vector<float> values((size_t)image.cols * channels);
+
+				for (int y = band.rowBegin; y < band.rowEnd; y++) {
+					generator(y, values.data());
+					expandChannels(values.data(), image.cols, channels);
+					storeRow(values.data(), image, y);
+				}
+			}, PATTERNS_MIN_BAND_HEIGHT);
+		}
+
+		/*! Add offsets to all values of a row with saturation.
+		*
+		* \param row [in,out] Row values
+		* \param offsets [in] Offsets
+		* \param count [in] Number of values
+		*/
+		template <typename T>
+		static void addRow(T* row, const float* offsets, int count) {
+			for (int i = 0; i < count; i++)
+				row[i] = cv::saturate_cast<T>((double)row[i] + offsets[i]);
+		}
+
+		/*! Add offsets to an image row by row in parallel.
+		*
+		* \param image [in,out] Image
+		* \param generator [in] Function filling the offsets of row y (one value per channel and pixel)
+		*/
+		static void addOffsets(cv::Mat& image, const function<void(int, float*)>& generator) {
+			int count = image.cols * image.channels();
+
+			parallelRows(image.rows, 0, [&](const RowBand& band) {
+				vector<float> offsets(count);
+
+				for (int y = band.rowBegin; y < band.rowEnd; y++) {
+					generator(y, offsets.data());
+
+					switch (image.depth()) {
+					case CV_8U:
+						addRow(image.ptr<uchar>(y), offsets.data(), count);
+						break;
+					case CV_8S:
+						addRow(image.ptr<schar>(y), offsets.data(), count);
+						break;
+					case CV_16U:
+						addRow(image.ptr<ushort>(y), offsets.data(), count);
+						break;
+					case CV_16S:
+						addRow(image.ptr<short>(y), offsets.data(), count);
+						break;
+					case CV_32S:
+						addRow(image.ptr<int>(y), offsets.data(), count);
+						break;
+					case CV_32F:
+						addRow(image.ptr<float>(y), offsets.data(), count);
+						break;
+					default:
+						addRow(image.ptr<double>(y), offsets.data(), count);
+					}
+				}
+			}, PATTERNS_MIN_BAND_HEIGHT);
+		}
+
+		/*! Create a linear ramp from the lowest to the highest value.
+		*
+		* \param image [out] Pattern image
+		* \param size [in] Image size
+		* \param type [in] Image type (any depth and number of channels)
+		* \param isHorizontal [in] Ramp from left to right, if true, from top to bottom otherwise
+		*/
+		void ramp(cv::Mat& image, cv::Size size, int type, bool isHorizontal) {
+			if (!isSupported(CV_MAT_DEPTH(type), "ramp"))
+				return;
+
+			vector<float> line(size.width);
+			for (int x = 0; x < size.width; x++)
+				line[x] = (size.width > 1) ? (float)x / (size.width - 1) : 0.0f;
+
+			generate(image, size, type, [&](int y, float* values) {
+				if (isHorizontal)
+					memcpy(values, line.data(), line.size() * sizeof(float));
+				else
+					fill(values, values + size.width, (size.height > 1) ? (float)y / (size.height - 1) : 0.0f);
+			});
+		}
+
+		/*! Create a checkerboard of alternating lowest and highest values.
+		*
+		* The top left cell has the highest value.
+		*
+		* \param image [out] Pattern image
+		* \param size [in] Image size
+		* \param type [in] Image type (any depth and number of channels)
+		* \param cellSize [in] Width and height of a cell in pixels
+		*/
+		void checkerboard(cv::Mat& image, cv::Size size, int type, int cellSize) {
+			if (!isSupported(CV_MAT_DEPTH(type), "checkerboard"))
+				return;
+
+			cellSize = max(cellSize, 1);
+			generate(image, size, type, [&](int y, float* values) {
+				float value = ((y / cellSize) & 1) ? 0.0f : 1.0f;
+
+				for (int x = 0; x < size.width; x += cellSize) {
+					fill(values + x, values + min(x + cellSize, size.width), value);
+					value = 1.0f - value;
+				}
+			});
+		}
+
+		/*! Create a chirp (cosine wave with linearly increasing frequency).
+		*
+		* The horizontal chirp starts with frequency 0 at the left border and reaches maxFrequency
+		* at the right border. The radial chirp (zone plate) starts at the image center and reaches
+		* maxFrequency at the nearest border. Frequencies above 0.5 cycles/pixel are aliased.
+		*
+		* \param image [out] Pattern image
+		* \param size [in] Image size
+		* \param type [in] Image type (any depth and number of channels)
+		* \param maxFrequency [in] Frequency at the border in cycles/pixel
+		* \param isRadial [in] Zone plate around the image center, if true, horizontal chirp otherwise
+		*/
+		void chirp(cv::Mat& image, cv::Size size, int type, double maxFrequency, bool isRadial) {
+			if (!isSupported(CV_MAT_DEPTH(type), "chirp"))
+				return;
+
+			// Phase(r) = pi * maxFrequency * r^2 / R has the frequency maxFrequency * r / R
+			double radius = isRadial ? max(min(size.width, size.height) / 2.0, 1.0) : max(size.width, 1);
+			double rate = M_PI * maxFrequency / radius;
+			double centerX = isRadial ? (size.width - 1) / 2.0 : 0.0, centerY = (size.height - 1) / 2.0;
+
+			// cos(a + b) = cos(a) * cos(b) - sin(a) * sin(b) separates the radial phase into columns and rows
+			vector<float> columnCos(size.width), columnSin(size.width);
+			for (int x = 0; x < size.width; x++) {
+				double phase = rate * (x - centerX) * (x - centerX);
+
+				columnCos[x] = (float)(0.5 * cos(phase));
+				columnSin[x] = (float)(0.5 * sin(phase));
+			}
+
+			generate(image, size, type, [&](int y, float* values) {
+				double phase = isRadial ? rate * (y - centerY) * (y - centerY) : 0.0;
+				float rowCos = (float)cos(phase), rowSin = (float)sin(phase);
+
+				for (int x = 0; x < size.width; x++)
+					values[x] = 0.5f + columnCos[x] * rowCos - columnSin[x] * rowSin;
+			});
+		}
+
+		/*! Create a sinusoidal grating.
+		*
+		* g(x,y) = 0.5 + 0.5 * sin(2 * pi * (x * cos(angle) + y * sin(angle)) / wavelength + phase),
+		* scaled to the value range of the depth.
+		*
+		* \param image [out] Pattern image
+		* \param size [in] Image size
+		* \param type [in] Image type (any depth and number of channels)
+		* \param wavelength [in] Wavelength in pixels
+		* \param angle [in] Direction of the wave in degrees (0: vertical stripes)
+		* \param phase [in] Phase offset in radians
+		*/
+		void sinusoid(cv::Mat& image, cv::Size size, int type, double wavelength, double angle, double phase) {
+			if (!isSupported(CV_MAT_DEPTH(type), "sinusoid"))
+				return;
+
+			double frequency = 2.0 * M_PI / max(wavelength, 1e-6);
+			double stepX = frequency * cos(angle * M_PI / 180.0), stepY = frequency * sin(angle * M_PI / 180.0);
+
+			generate(image, size, type, [&](int y, float* values) {
+				sineRow(values, size.width, phase + y * stepY, stepX, 0.5, 0.5);
+			});
+		}
+
+		/*! Create uniformly distributed noise.
+		*
+		* Integer depths are filled with random bits (uniform in the full range), floating-point
+		* depths with values in (0, 1]. Channels are independent.
+		*
+		* \param image [out] Pattern image
+		* \param size [in] Image size
+		* \param type [in] Image type (any depth and number of channels)
+		* \param seed [in] Seed of the random numbers
+		*/
+		void uniformNoise(cv::Mat& image, cv::Size size, int type, uint64_t seed) {
+			if (!isSupported(CV_MAT_DEPTH(type), "uniformNoise"))
+				return;
+
+			image.create(size, type);
+			parallelRows(image.rows, 0, [&](const RowBand& band) {
+				int count = image.cols * image.channels();
+
+				for (int y = band.rowBegin; y < band.rowEnd; y++) {
+					uint64_t state = rowState(seed, y);
+
+					if (image.depth() == CV_32F) {
+						float* row = image.ptr<float>(y);
+						for (int i = 0; i < count; i++)
+							row[i] = unitFloat(splitMix64(state));
+					}
+					else if (image.depth() == CV_64F) {
+						double* row = image.ptr<double>(y);
+						for (int i = 0; i < count; i++)
+							row[i] = (double)((splitMix64(state) >> 11) + 1) * (1.0 / 9007199254740992.0);
+					}
+					else {
+						uchar* row = image.ptr<uchar>(y);
+						size_t bytes = (size_t)count * image.elemSize1(), i = 0;
+
+						for (; i + 8 <= bytes; i += 8) {
+							uint64_t bits = splitMix64(state);
+							memcpy(row + i, &bits, 8);
+						}
+						if (i < bytes) {
+							uint64_t bits = splitMix64(state);
+							memcpy(row + i, &bits, bytes - i);
+						}
+					}
+				}
+			}, PATTERNS_MIN_BAND_HEIGHT);
+		}
+
+		/*! Corrupt an image by an additive sinusoidal wave (periodic noise).
+		*
+		* Added: noise(x,y) = amplitude * sin(2 * pi * (x * cos(angle) + y * sin(angle)) / wavelength),
+		* results are saturated to the value range of the depth.
+		*
+		* \param image [in,out] Image to be corrupted (any depth and number of channels)
+		* \param amplitude [in] Amplitude in pixel values
+		* \param wavelength [in] Wavelength in pixels
+		* \param angle [in] Direction of the wave in degrees
+		*/
+		void addSinusoidal(cv::Mat& image, double amplitude, double wavelength, double angle) {
+			if (!isSupported(image.depth(), "addSinusoidal"))
+				return;
+
+			double frequency = 2.0 * M_PI / max(wavelength, 1e-6);
+			double stepX = frequency * cos(angle * M_PI / 180.0), stepY = frequency * sin(angle * M_PI / 180.0);
+			int channels = image.channels();
+
+			addOffsets(image, [&](int y, float* offsets) {
+				sineRow(offsets, image.cols, y * stepY, stepX, amplitude, 0.0);
+				expandChannels(offsets, image.cols, channels);
+			});
+		}
+
+		/*! Corrupt an image by additive Gaussian noise.
+		*
+		* Approximately normally distributed values (sum of four uniform 16-bit random numbers, i. e.,
+		* one random number per value, limited to +-3.46 sigma) are added to every channel independently.
+		* Results are saturated to the value range of the depth.
+		*
+		* \param image [in,out] Image to be corrupted (any depth and number of channels)
+		* \param sigma [in] Standard deviation in pixel values
+		* \param seed [in] Seed of the random numbers
+		*/
+		void addGaussianNoise(cv::Mat& image, double sigma, uint64_t seed) {
+			if (!isSupported(image.depth(), "addGaussianNoise"))
+				return;
+
+			// Sum of 4 uniform values in [0, 65535]: mean 4 * 32767.5, variance 4 * (65536^2 - 1) / 12
+			const float mean = 4 * 32767.5f, scale = (float)(sigma / sqrt(4.0 * (65536.0 * 65536.0 - 1.0) / 12.0));
+			int count = image.cols * image.channels();
+
+			addOffsets(image, [&](int y, float* offsets) {
+				uint64_t state = rowState(seed, y);
+
+				for (int i = 0; i < count; i++) {
+					uint64_t bits = splitMix64(state);
+					uint32_t sum = (uint32_t)(bits & 0xFFFF) + (uint32_t)((bits >> 16) & 0xFFFF)
+						+ (uint32_t)((bits >> 32) & 0xFFFF) + (uint32_t)(bits >> 48);
+
+					offsets[i] = ((float)sum - mean) * scale;
+				}
+			});
+		}
+
+		/*! Set random pixels to the lowest or highest value (all channels).
+		*
+		* \param row [in,out] Row values
+		* \param cols [in] Number of pixels
+		* \param channels [in] Number of channels
+		* \param state [in,out] Generator state of the row
+		* \param threshold [in] Pixels with a random number below threshold are changed
+		* \param low [in] Pepper value
+		* \param high [in] Salt value
+		*/
+		template <typename T>
+		static void saltAndPepperRow(T* row, int cols, int channels, uint64_t& state, uint64_t threshold, T low, T high) {
+			for (int x = 0; x < cols; x++) {
+				uint64_t bits = splitMix64(state) >> 32;
+
+				if (bits < threshold) {
+					T value = (bits < threshold / 2) ? low : high;
+
+					for (int c = 0; c < channels; c++)
+						row[x * channels + c] = value;
+				}
+			}
+		}
+
+		/*! Corrupt an image by salt-and-pepper (impulse) noise.
+		*
+		* Half of the corrupted pixels are set to the lowest, half to the highest value of the depth
+		* ([0, 1] for floating-point depths).
+		*
+		* \param image [in,out] Image to be corrupted (any depth and number of channels)
+		* \param density [in] Fraction of corrupted pixels [0, 1]
+		* \param seed [in] Seed of the random numbers
+		*/
+		void addSaltAndPepper(cv::Mat& image, double density, uint64_t seed) {
+			if (!isSupported(image.depth(), "addSaltAndPepper"))
+				return;
+
+			uint64_t threshold = (uint64_t)(min(max(density, 0.0), 1.0) * 4294967296.0);
+			int channels = image.channels();
+			double low, high;
+
+			depthRange(image.depth(), low, high);
+			parallelRows(image.rows, 0, [&](const RowBand& band) {
+				for (int y = band.rowBegin; y < band.rowEnd; y++) {
+					uint64_t state = rowState(seed, y);
+
+					switch (image.depth()) {
+					case CV_8U:
+						saltAndPepperRow(image.ptr<uchar>(y), image.cols, channels, state, threshold, (uchar)low, (uchar)high);
+						break;
+					case CV_8S:
+						saltAndPepperRow(image.ptr<schar>(y), image.cols, channels, state, threshold, (schar)low, (schar)high);
+						break;
+					case CV_16U:
+						saltAndPepperRow(image.ptr<ushort>(y), image.cols, channels, state, threshold, (ushort)low, (ushort)high);
+						break;
+					case CV_16S:
+						saltAndPepperRow(image.ptr<short>(y), image.cols, channels, state, threshold, (short)low, (short)high);
+						break;
+					case CV_32S:
+						saltAndPepperRow(image.ptr<int>(y), image.cols, channels, state, threshold, (int)low, (int)high);
+						break;
+					case CV_32F:
+						saltAndPepperRow(image.ptr<float>(y), image.cols, channels, state, threshold, (float)low, (float)high);
+						break;
+					default:
+						saltAndPepperRow(image.ptr<double>(y), image.cols, channels, state, threshold, low, high);
+					}
+				}
+			}, PATTERNS_MIN_BAND_HEIGHT);
+		}
+	}
+}
@@ -0,0 +1,40 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_PATTERNS_H
+#define IP_PATTERNS_H
+
+/* Include files */
+#include <cstdint>						// Declare uint64_t
+#include <opencv2/core/core.hpp>
+
+namespace ip
+{
+	/*! Synthetic test patterns of any size and type.
+	*
+	* Generators fill the full value range of the image depth (integer depths) or [0, 1]
+	* (floating-point depths), multi-channel images get the same value in all channels.
+	* Rows are generated in parallel, random patterns are seeded per row, so results depend
+	* on the seed only (not on the number of threads). Images are reallocated only if size or
+	* type change, so benchmarks can regenerate patterns without allocations.
+	*/
+	namespace patterns
+	{
+		void ramp(cv::Mat& image, cv::Size size, int type = CV_8U, bool isHorizontal = true);
+		void checkerboard(cv::Mat& image, cv::Size size, int type = CV_8U, int cellSize = 32);
+		void chirp(cv::Mat& image, cv::Size size, int type = CV_8U, double maxFrequency = 0.5, bool isRadial = false);
+		void sinusoid(cv::Mat& image, cv::Size size, int type = CV_8U, double wavelength = 16.0, double angle = 0.0, double phase = 0.0);
+		void uniformNoise(cv::Mat& image, cv::Size size, int type = CV_8U, uint64_t seed = 0);
+
+		void addSinusoidal(cv::Mat& image, double amplitude, double wavelength = 8.0, double angle = 45.0);
+		void addGaussianNoise(cv::Mat& image, double sigma, uint64_t seed = 0);
+		void addSaltAndPepper(cv::Mat& image, double density, uint64_t seed = 0);
+	}
+}
+
+#endif /* IP_PATTERNS_H */
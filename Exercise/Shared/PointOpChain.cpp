@@ -0,0 +1,129 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Include files */
+#include <iostream>
+#include "PointOpChain.h"
+#include "Parallel.h"
+#include "SimdKernels.h"
+
+/* Namespaces */
+using namespace std;
+
+namespace ip
+{
+	/*! Remove all point operations (identity mapping). */
+	void PointOpChain::reset() {
+		for (int g = 0; g < 256; g++)
+			lut[g] = (uchar)g;
+	}
+
+	/*! Append a point operation given by its LUT.
+	*
+	* \param next LUT applied to the result of the chain so far
+	* \return chain
+	*/
+	PointOpChain& PointOpChain::then(const uchar next[256]) {
+		for (int g = 0; g < 256; g++)
+			lut[g] = next[lut[g]];
+		return *this;
+	}
+
+	/*! Append a point operation given by its LUT.
+	*
+	* \param next LUT applied to the result of the chain so far (1x256 or 256x1, type CV_8U)
+	* \return chain
+	*/
+	PointOpChain& PointOpChain::then(const cv::Mat& next) {
+		if ((next.type() != CV_8U) || (next.total() != 256) || !next.isContinuous()) {
+			cout << "[WARNING] LUT of 256 elements of type CV_8U expected. LUT ignored." << endl;
+			return *this;
+		}
+		return then(next.ptr<uchar>(0));
+	}
+
+	/*! Append inversion g -> 255 - g.
+	*
+	* \return chain
+	*/
+	PointOpChain& PointOpChain::invert() {
+		for (int g = 0; g < 256; g++)
+			lut[g] = (uchar)(255 - lut[g]);
+		return *this;
+	}
+
+	/*! Append clamping to [min, max].
+	*
+	* \param min Lower bound
+	* \param max Upper bound
+	* \return chain
+	*/
+	PointOpChain& PointOpChain::clamp(uchar min, uchar max) {
+		for (int g = 0; g < 256; g++) {
+			if (lut[g] < min)
+				lut[g] = min;
+			else if (lut[g] > max)
+				lut[g] = max;
+		}
+		return *this;
+	}
+
+	/*! Append linear contrast stretching of [min, max] to [0, 255] (values outside are clamped).
+	*
+	* \param min Gray value mapped to 0
+	* \param max Gray value mapped to 255 (> min)
+	* \return chain
+	*/
+	PointOpChain& PointOpChain::stretch(int min, int max) {
+		if (max <= min) {
+			cout << "[WARNING] Stretching requires max > min. Operation ignored." << endl;
+			return *this;
+		}
+
+		for (int g = 0; g < 256; g++) {
+			int value = (int)(255.0 * ((double)lut[g] - min) / ((double)max - min) + 0.5);
+			lut[g] = (uchar)((value < 0) ? 0 : ((value > 255) ? 255 : value));
+		}
+		return *this;
+	}
+
+	/*! Append binary threshold (g > thresh -> 255, otherwise 0).
+	*
+	* \param thresh Threshold
+	* \return chain
+	*/
+	PointOpChain& PointOpChain::threshold(uchar thresh) {
+		for (int g = 0; g < 256; g++)
+			lut[g] = (lut[g] > thresh) ? 255 : 0;
+		return *this;
+	}
+
+	/*! Apply the chain of point operations to an image in a single pass.
+	*
+	* Bands of rows are mapped in parallel, each row by vectorized table lookups (see lookupRow()).
+	* All channels are mapped by the same LUT.
+	*
+	* \param image [in] Source image (depth CV_8U, any number of channels)
+	* \param processed [out] Destination image (may be the source image)
+	*/
+	void PointOpChain::apply(const cv::Mat& image, cv::Mat& processed) const {
+		// Check for correct image depth (8 bit)
+		if (image.depth() != CV_8U) {
+			cout << "[WARNING] Incorrect image depth. CV_8U expected." << endl;
+			return;
+		}
+
+		processed.create(image.rows, image.cols, image.type());
+
+		int count = image.cols * image.channels();
+
+		parallelRows(image.rows, 0, [&](const RowBand& band) {
+			for (int y = band.rowBegin; y < band.rowEnd; y++)
+				lookupRow(image.ptr<uchar>(y), processed.ptr<uchar>(y), count, lut);
+		}, 16);
+	}
+}
@@ -0,0 +1,47 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_POINT_OP_CHAIN_H
+#define IP_POINT_OP_CHAIN_H
+
+/* Include files */
+#include <opencv2/core/core.hpp>
+
+namespace ip
+{
+	/*! Chain of point operations applied in a single pass.
+	*
+	* Each point operation is a mapping of the 256 gray values. Appending an operation composes
+	* its LUT with the LUT of the chain so far (256 lookups), so applying N operations costs
+	* one pass over the image instead of N.
+	*
+	* Example: ip::PointOpChain().stretch(20, 200).invert().clamp(16, 235).apply(image, processed);
+	*/
+	class PointOpChain {
+	public:
+		PointOpChain() { reset(); }
+		void reset();
+
+		PointOpChain& then(const uchar lut[256]);
+		PointOpChain& then(const cv::Mat& lut);
+		PointOpChain& then(const PointOpChain& chain) { return then(chain.lut); }
+		PointOpChain& invert();
+		PointOpChain& clamp(uchar min, uchar max);
+		PointOpChain& stretch(int min, int max);
+		PointOpChain& threshold(uchar thresh);
+
+		uchar operator()(uchar value) const { return lut[value]; }
+		const uchar* table() const { return lut; }
+		void apply(const cv::Mat& image, cv::Mat& processed) const;
+
+	private:
+		uchar lut[256];
+	};
+}
+
+#endif /* IP_POINT_OP_CHAIN_H */
@@ -0,0 +1,78 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Include files */
+#include "Simd.h"
+
+#if defined(IP_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>						// Declare __cpuid(), __cpuidex(), _xgetbv()
+#endif
+
+namespace ip
+{
+	/*! Currently used instruction set level (detected on first use). */
+	static SimdLevel& currentSimdLevel() {
+		static SimdLevel level = detectSimdLevel();
+		return level;
+	}
+
+	/*! Detect the best instruction set level supported by CPU and operating system.
+	*
+	* AVX2 requires the CPUID feature flag and the operating system to save the YMM
+	* registers (OSXSAVE and XCR0).
+	*
+	* \return best supported instruction set level
+	*/
+	SimdLevel detectSimdLevel() {
+#if defined(IP_SIMD_X86) && defined(_MSC_VER)
+		int info[4] = { 0 };
+
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		bool isSse2 = (info[3] & (1 << 26)) != 0;
+		bool isOsxsave = (info[2] & (1 << 27)) != 0;
+		bool isAvx = (info[2] & (1 << 28)) != 0;
+
+		if (!isSse2)
+			return SIMD_NONE;
+		if ((maxLeaf < 7) || !isOsxsave || !isAvx || ((_xgetbv(0) & 0x6) != 0x6))
+			return SIMD_SSE2;
+
+		__cpuidex(info, 7, 0);
+		return ((info[1] & (1 << 5)) != 0) ? SIMD_AVX2 : SIMD_SSE2;
+#elif defined(IP_SIMD_X86)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return SIMD_AVX2;
+		return __builtin_cpu_supports("sse2") ? SIMD_SSE2 : SIMD_NONE;
+#else
+		return SIMD_NONE;
+#endif
+	}
+
+	/*! Get the instruction set level used by SIMD code paths.
+	*
+	* \return instruction set level
+	*/
+	SimdLevel getSimdLevel() {
+		return currentSimdLevel();
+	}
+
+	/*! Limit the instruction set level used by SIMD code paths.
+	*
+	* SIMD_NONE selects the scalar reference implementations, e. g., to compare results
+	* and runtimes. Levels not supported by the CPU are reduced to the detected level.
+	*
+	* \param level Requested instruction set level
+	*/
+	void setSimdLevel(SimdLevel level) {
+		SimdLevel detected = detectSimdLevel();
+		currentSimdLevel() = (level < detected) ? level : detected;
+	}
+}
@@ -0,0 +1,37 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_SIMD_H
+#define IP_SIMD_H
+
+/* Defines */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define IP_SIMD_X86 1								// SSE2/AVX2 code paths available
+#endif
+
+// Compile single functions for instruction sets not enabled for the entire project
+// (MSVC accepts intrinsics of all instruction sets without further settings)
+#if defined(IP_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define IP_TARGET_SSE2 __attribute__((target("sse2")))
+#define IP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define IP_TARGET_SSE2
+#define IP_TARGET_AVX2
+#endif
+
+namespace ip
+{
+	/*! Instruction set levels for SIMD code paths (ascending). */
+	enum SimdLevel { SIMD_NONE, SIMD_SSE2, SIMD_AVX2 };
+
+	SimdLevel detectSimdLevel();
+	SimdLevel getSimdLevel();
+	void setSimdLevel(SimdLevel level);
+}
+
+#endif /* IP_SIMD_H */
@@ -0,0 +1,455 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Include files */
+#include <cmath>
+#include "SimdKernels.h"
+
+#ifdef IP_SIMD_X86
+#include <immintrin.h>					// SSE2 and AVX2 intrinsics
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>						// Declare _BitScanForward()
+#endif
+
+/* Namespaces */
+using namespace std;
+
+namespace ip
+{
+#ifdef IP_SIMD_X86
+	/*! Vertical 1-2-1 sums of three rows as two vectors of 8 unsigned 16-bit values. */
+	static inline IP_TARGET_SSE2 void sum121Sse2(const uchar* first, const uchar* second, const uchar* third, __m128i& lo, __m128i& hi) {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i a = _mm_loadu_si128((const __m128i*)first);
+		__m128i b = _mm_loadu_si128((const __m128i*)second);
+		__m128i c = _mm_loadu_si128((const __m128i*)third);
+
+		lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(c, zero)), _mm_slli_epi16(_mm_unpacklo_epi8(b, zero), 1));
+		hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(c, zero)), _mm_slli_epi16(_mm_unpackhi_epi8(b, zero), 1));
+	}
+
+	/*! Vertical 1-2-1 sums of three rows as two vectors of 16 unsigned 16-bit values (in-lane order). */
+	static inline IP_TARGET_AVX2 void sum121Avx2(const uchar* first, const uchar* second, const uchar* third, __m256i& lo, __m256i& hi) {
+		const __m256i zero = _mm256_setzero_si256();
+		__m256i a = _mm256_loadu_si256((const __m256i*)first);
+		__m256i b = _mm256_loadu_si256((const __m256i*)second);
+		__m256i c = _mm256_loadu_si256((const __m256i*)third);
+
+		lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(c, zero)), _mm256_slli_epi16(_mm256_unpacklo_epi8(b, zero), 1));
+		hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(c, zero)), _mm256_slli_epi16(_mm256_unpackhi_epi8(b, zero), 1));
+	}
+
+	static IP_TARGET_SSE2 int binomialRow3x3Sse2(const uchar* above, const uchar* center, const uchar* below, uchar* dst, int count) {
+		const __m128i rounding = _mm_set1_epi16(8);
+		int x = 0;
+
+		for (; x + 16 <= count; x += 16) {
+			__m128i leftLo, leftHi, centerLo, centerHi, rightLo, rightHi;
+
+			sum121Sse2(above + x - 1, center + x - 1, below + x - 1, leftLo, leftHi);
+			sum121Sse2(above + x, center + x, below + x, centerLo, centerHi);
+			sum121Sse2(above + x + 1, center + x + 1, below + x + 1, rightLo, rightHi);
+
+			__m128i lo = _mm_add_epi16(_mm_add_epi16(leftLo, rightLo), _mm_add_epi16(_mm_slli_epi16(centerLo, 1), rounding));
+			__m128i hi = _mm_add_epi16(_mm_add_epi16(leftHi, rightHi), _mm_add_epi16(_mm_slli_epi16(centerHi, 1), rounding));
+			_mm_storeu_si128((__m128i*)(dst + x), _mm_packus_epi16(_mm_srli_epi16(lo, 4), _mm_srli_epi16(hi, 4)));
+		}
+		return x;
+	}
+
+	static IP_TARGET_AVX2 int binomialRow3x3Avx2(const uchar* above, const uchar* center, const uchar* below, uchar* dst, int count) {
+		const __m256i rounding = _mm256_set1_epi16(8);
+		int x = 0;
+
+		for (; x + 32 <= count; x += 32) {
+			__m256i leftLo, leftHi, centerLo, centerHi, rightLo, rightHi;
+
+			sum121Avx2(above + x - 1, center + x - 1, below + x - 1, leftLo, leftHi);
+			sum121Avx2(above + x, center + x, below + x, centerLo, centerHi);
+			sum121Avx2(above + x + 1, center + x + 1, below + x + 1, rightLo, rightHi);
+
+			__m256i lo = _mm256_add_epi16(_mm256_add_epi16(leftLo, rightLo), _mm256_add_epi16(_mm256_slli_epi16(centerLo, 1), rounding));
+			__m256i hi = _mm256_add_epi16(_mm256_add_epi16(leftHi, rightHi), _mm256_add_epi16(_mm256_slli_epi16(centerHi, 1), rounding));
+			_mm256_storeu_si256((__m256i*)(dst + x), _mm256_packus_epi16(_mm256_srli_epi16(lo, 4), _mm256_srli_epi16(hi, 4)));
+		}
+		return x;
+	}
+
+	static IP_TARGET_SSE2 int binomialRow121Sse2(const uchar* first, const uchar* second, const uchar* third, uchar* dst, int count) {
+		int x = 0;
+
+		for (; x + 16 <= count; x += 16) {
+			__m128i lo, hi;
+
+			sum121Sse2(first + x, second + x, third + x, lo, hi);
+			_mm_storeu_si128((__m128i*)(dst + x), _mm_packus_epi16(_mm_srli_epi16(lo, 2), _mm_srli_epi16(hi, 2)));
+		}
+		return x;
+	}
+
+	static IP_TARGET_AVX2 int binomialRow121Avx2(const uchar* first, const uchar* second, const uchar* third, uchar* dst, int count) {
+		int x = 0;
+
+		for (; x + 32 <= count; x += 32) {
+			__m256i lo, hi;
+
+			sum121Avx2(first + x, second + x, third + x, lo, hi);
+			_mm256_storeu_si256((__m256i*)(dst + x), _mm256_packus_epi16(_mm256_srli_epi16(lo, 2), _mm256_srli_epi16(hi, 2)));
+		}
+		return x;
+	}
+
+	static IP_TARGET_SSE2 int minMaxRowsSse2(const uchar* minA, const uchar* minB, const uchar* maxA, const uchar* maxB, uchar* minDst, uchar* maxDst, int count) {
+		int x = 0;
+
+		for (; x + 16 <= count; x += 16) {
+			__m128i minimum = _mm_min_epu8(_mm_loadu_si128((const __m128i*)(minA + x)), _mm_loadu_si128((const __m128i*)(minB + x)));
+			__m128i maximum = _mm_max_epu8(_mm_loadu_si128((const __m128i*)(maxA + x)), _mm_loadu_si128((const __m128i*)(maxB + x)));
+
+			_mm_storeu_si128((__m128i*)(minDst + x), minimum);
+			_mm_storeu_si128((__m128i*)(maxDst + x), maximum);
+		}
+		return x;
+	}
+
+	static IP_TARGET_AVX2 int minMaxRowsAvx2(const uchar* minA, const uchar* minB, const uchar* maxA, const uchar* maxB, uchar* minDst, uchar* maxDst, int count) {
+		int x = 0;
+
+		for (; x + 32 <= count; x += 32) {
+			__m256i minimum = _mm256_min_epu8(_mm256_loadu_si256((const __m256i*)(minA + x)), _mm256_loadu_si256((const __m256i*)(minB + x)));
+			__m256i maximum = _mm256_max_epu8(_mm256_loadu_si256((const __m256i*)(maxA + x)), _mm256_loadu_si256((const __m256i*)(maxB + x)));
+
+			_mm256_storeu_si256((__m256i*)(minDst + x), minimum);
+			_mm256_storeu_si256((__m256i*)(maxDst + x), maximum);
+		}
+		return x;
+	}
+
+	// Half difference (b - a) >> 1 by the rounding average of b and 255 - a:
+	// (b + 255 - a + 1) >> 1 = ((b - a) >> 1) + 128, hence flipping the sign bit yields the result
+	static IP_TARGET_SSE2 int halfDifferenceRowSse2(const uchar* first, const uchar* second, schar* dst, int count) {
+		const __m128i signBit = _mm_set1_epi8((char)0x80), ones = _mm_set1_epi8((char)0xFF);
+		int x = 0;
+
+		for (; x + 16 <= count; x += 16) {
+			__m128i a = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(first + x)), ones);
+			__m128i average = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(second + x)), a);
+
+			_mm_storeu_si128((__m128i*)(dst + x), _mm_xor_si128(average, signBit));
+		}
+		return x;
+	}
+
+	static IP_TARGET_AVX2 int halfDifferenceRowAvx2(const uchar* first, const uchar* second, schar* dst, int count) {
+		const __m256i signBit = _mm256_set1_epi8((char)0x80), ones = _mm256_set1_epi8((char)0xFF);
+		int x = 0;
+
+		for (; x + 32 <= count; x += 32) {
+			__m256i a = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(first + x)), ones);
+			__m256i average = _mm256_avg_epu8(_mm256_loadu_si256((const __m256i*)(second + x)), a);
+
+			_mm256_storeu_si256((__m256i*)(dst + x), _mm256_xor_si256(average, signBit));
+		}
+		return x;
+	}
+
+	// Squared magnitudes gx^2 + gy^2 <= 2 * 128^2 by multiply-add of interleaved 16-bit pairs,
+	// truncated square root in single precision (exact for integers of this range)
+	static inline IP_TARGET_SSE2 __m128i sqrtPairsSse2(__m128i gx, __m128i gy) {
+		__m128i lo = _mm_unpacklo_epi16(gx, gy), hi = _mm_unpackhi_epi16(gx, gy);
+		__m128i magnitudesLo = _mm_cvttps_epi32(_mm_sqrt_ps(_mm_cvtepi32_ps(_mm_madd_epi16(lo, lo))));
+		__m128i magnitudesHi = _mm_cvttps_epi32(_mm_sqrt_ps(_mm_cvtepi32_ps(_mm_madd_epi16(hi, hi))));
+
+		return _mm_packs_epi32(magnitudesLo, magnitudesHi);
+	}
+
+	static IP_TARGET_SSE2 int magnitudeRowSse2(const schar* gradX, const schar* gradY, uchar* dst, int count) {
+		const __m128i zero = _mm_setzero_si128();
+		int x = 0;
+
+		for (; x + 16 <= count; x += 16) {
+			__m128i gx = _mm_loadu_si128((const __m128i*)(gradX + x));
+			__m128i gy = _mm_loadu_si128((const __m128i*)(gradY + x));
+
+			// Sign extension to 16 bit
+			__m128i lo = sqrtPairsSse2(_mm_srai_epi16(_mm_unpacklo_epi8(zero, gx), 8), _mm_srai_epi16(_mm_unpacklo_epi8(zero, gy), 8));
+			__m128i hi = sqrtPairsSse2(_mm_srai_epi16(_mm_unpackhi_epi8(zero, gx), 8), _mm_srai_epi16(_mm_unpackhi_epi8(zero, gy), 8));
+			_mm_storeu_si128((__m128i*)(dst + x), _mm_packus_epi16(lo, hi));
+		}
+		return x;
+	}
+
+	static inline IP_TARGET_AVX2 __m256i sqrtPairsAvx2(__m256i gx, __m256i gy) {
+		__m256i lo = _mm256_unpacklo_epi16(gx, gy), hi = _mm256_unpackhi_epi16(gx, gy);
+		__m256i magnitudesLo = _mm256_cvttps_epi32(_mm256_sqrt_ps(_mm256_cvtepi32_ps(_mm256_madd_epi16(lo, lo))));
+		__m256i magnitudesHi = _mm256_cvttps_epi32(_mm256_sqrt_ps(_mm256_cvtepi32_ps(_mm256_madd_epi16(hi, hi))));
+
+		return _mm256_packs_epi32(magnitudesLo, magnitudesHi);
+	}
+
+	static IP_TARGET_AVX2 int magnitudeRowAvx2(const schar* gradX, const schar* gradY, uchar* dst, int count) {
+		const __m256i zero = _mm256_setzero_si256();
+		int x = 0;
+
+		for (; x + 32 <= count; x += 32) {
+			__m256i gx = _mm256_loadu_si256((const __m256i*)(gradX + x));
+			__m256i gy = _mm256_loadu_si256((const __m256i*)(gradY + x));
+
+			// Sign extension to 16 bit (unpacking and packing within 128-bit lanes keeps the order)
+			__m256i lo = sqrtPairsAvx2(_mm256_srai_epi16(_mm256_unpacklo_epi8(zero, gx), 8), _mm256_srai_epi16(_mm256_unpacklo_epi8(zero, gy), 8));
+			__m256i hi = sqrtPairsAvx2(_mm256_srai_epi16(_mm256_unpackhi_epi8(zero, gx), 8), _mm256_srai_epi16(_mm256_unpackhi_epi8(zero, gy), 8));
+			_mm256_storeu_si256((__m256i*)(dst + x), _mm256_packus_epi16(lo, hi));
+		}
+		return x;
+	}
+
+	// Table lookup by byte shuffles: The LUT is split into 16 tables of 16 entries. For table i,
+	// (g - 16 i) saturated by + 0x70 keeps the low nibble of g and has the sign bit clear only
+	// for 16 i <= g < 16 (i + 1), so the shuffle yields the entry for these pixels and 0 otherwise
+	static IP_TARGET_AVX2 int lookupRowAvx2(const uchar* src, uchar* dst, int count, const uchar lut[256]) {
+		const __m256i step = _mm256_set1_epi8(16), offset = _mm256_set1_epi8(0x70);
+		__m256i tables[16];
+		int x = 0;
+
+		for (int i = 0; i < 16; i++)
+			tables[i] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(lut + 16 * i)));
+
+		for (; x + 32 <= count; x += 32) {
+			__m256i index = _mm256_loadu_si256((const __m256i*)(src + x));
+			__m256i result = _mm256_shuffle_epi8(tables[0], _mm256_adds_epu8(index, offset));
+
+			for (int i = 1; i < 16; i++) {
+				index = _mm256_sub_epi8(index, step);
+				result = _mm256_or_si256(result, _mm256_shuffle_epi8(tables[i], _mm256_adds_epu8(index, offset)));
+			}
+			_mm256_storeu_si256((__m256i*)(dst + x), result);
+		}
+		return x;
+	}
+
+	/*! Index of the lowest set bit (mask must not be 0). */
+	static inline int lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return (int)index;
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	// Compaction by movemask: Blocks without nonzero pixels are skipped by one compare,
+	// the columns of the others are extracted bit by bit from the mask
+	static IP_TARGET_SSE2 int nonZeroColumnsSse2(const uchar* src, int count, int* columns, int& numColumns) {
+		const __m128i zero = _mm_setzero_si128();
+		int x = 0;
+
+		for (; x + 16 <= count; x += 16) {
+			__m128i pixels = _mm_loadu_si128((const __m128i*)(src + x));
+			unsigned mask = ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(pixels, zero)) & 0xFFFF;
+
+			for (; mask; mask &= mask - 1)
+				columns[numColumns++] = x + lowestBit(mask);
+		}
+		return x;
+	}
+
+	static IP_TARGET_AVX2 int nonZeroColumnsAvx2(const uchar* src, int count, int* columns, int& numColumns) {
+		const __m256i zero = _mm256_setzero_si256();
+		int x = 0;
+
+		for (; x + 32 <= count; x += 32) {
+			__m256i pixels = _mm256_loadu_si256((const __m256i*)(src + x));
+			unsigned mask = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(pixels, zero));
+
+			for (; mask; mask &= mask - 1)
+				columns[numColumns++] = x + lowestBit(mask);
+		}
+		return x;
+	}
+#endif
+
+	/*! Apply 3x3 binomial filter (1 2 1)^T (1 2 1) / 16 with rounding to one row.
+	*
+	* \param above [in] Source row above, pointing to the column of the first result
+	* \param center [in] Source row, pointing to the column of the first result
+	* \param below [in] Source row below, pointing to the column of the first result
+	* \param dst [out] Resulting pixels
+	* \param count [in] Number of resulting pixels (source rows are read from -1 to count)
+	*/
+	void binomialRow3x3(const uchar* above, const uchar* center, const uchar* below, uchar* dst, int count) {
+		int x = 0;
+
+#ifdef IP_SIMD_X86
+		SimdLevel level = getSimdLevel();
+		if (level >= SIMD_AVX2)
+			x = binomialRow3x3Avx2(above, center, below, dst, count);
+		else if (level >= SIMD_SSE2)
+			x = binomialRow3x3Sse2(above, center, below, dst, count);
+#endif
+
+		// Scalar reference (and remaining pixels)
+		for (; x < count; x++) {
+			int left = above[x - 1] + 2 * center[x - 1] + below[x - 1];
+			int middle = above[x] + 2 * center[x] + below[x];
+			int right = above[x + 1] + 2 * center[x + 1] + below[x + 1];
+
+			dst[x] = (uchar)((left + 2 * middle + right + 8) >> 4);
+		}
+	}
+
+	/*! Apply 1D binomial filter (1 2 1) / 4 with truncation to three rows or shifted row pointers.
+	*
+	* \param first [in] First source pixels (weight 1)
+	* \param second [in] Second source pixels (weight 2)
+	* \param third [in] Third source pixels (weight 1)
+	* \param dst [out] Resulting pixels (first + 2 * second + third) >> 2
+	* \param count [in] Number of pixels
+	*/
+	void binomialRow121(const uchar* first, const uchar* second, const uchar* third, uchar* dst, int count) {
+		int x = 0;
+
+#ifdef IP_SIMD_X86
+		SimdLevel level = getSimdLevel();
+		if (level >= SIMD_AVX2)
+			x = binomialRow121Avx2(first, second, third, dst, count);
+		else if (level >= SIMD_SSE2)
+			x = binomialRow121Sse2(first, second, third, dst, count);
+#endif
+
+		// Scalar reference (and remaining pixels)
+		for (; x < count; x++) {
+			int sum = (int)first[x] + ((int)second[x] << 1) + (int)third[x];
+			dst[x] = (uchar)(sum >> 2);
+		}
+	}
+
+	/*! Pixel-wise minimum and maximum of two pairs of rows.
+	*
+	* \param minA [in] First row for minimum
+	* \param minB [in] Second row for minimum
+	* \param maxA [in] First row for maximum
+	* \param maxB [in] Second row for maximum
+	* \param minDst [out] Resulting minimum (may be identical to minA or minB)
+	* \param maxDst [out] Resulting maximum (may be identical to maxA or maxB)
+	* \param count [in] Number of pixels
+	*/
+	void minMaxRows(const uchar* minA, const uchar* minB, const uchar* maxA, const uchar* maxB, uchar* minDst, uchar* maxDst, int count) {
+		int x = 0;
+
+#ifdef IP_SIMD_X86
+		SimdLevel level = getSimdLevel();
+		if (level >= SIMD_AVX2)
+			x = minMaxRowsAvx2(minA, minB, maxA, maxB, minDst, maxDst, count);
+		else if (level >= SIMD_SSE2)
+			x = minMaxRowsSse2(minA, minB, maxA, maxB, minDst, maxDst, count);
+#endif
+
+		// Scalar reference (and remaining pixels)
+		for (; x < count; x++) {
+			minDst[x] = min(minA[x], minB[x]);
+			maxDst[x] = max(maxA[x], maxB[x]);
+		}
+	}
+
+	/*! Signed half difference of two rows or shifted row pointers.
+	*
+	* \param first [in] Subtrahend pixels
+	* \param second [in] Minuend pixels
+	* \param dst [out] Resulting differences (second - first) >> 1 in [-128, 127]
+	* \param count [in] Number of pixels
+	*/
+	void halfDifferenceRow(const uchar* first, const uchar* second, schar* dst, int count) {
+		int x = 0;
+
+#ifdef IP_SIMD_X86
+		SimdLevel level = getSimdLevel();
+		if (level >= SIMD_AVX2)
+			x = halfDifferenceRowAvx2(first, second, dst, count);
+		else if (level >= SIMD_SSE2)
+			x = halfDifferenceRowSse2(first, second, dst, count);
+#endif
+
+		// Scalar reference (and remaining pixels)
+		for (; x < count; x++)
+			dst[x] = (schar)(((int)second[x] - (int)first[x]) >> 1);
+	}
+
+	/*! Gradient magnitude of signed gradients in x and y.
+	*
+	* \param gradX [in] Signed gradients in x
+	* \param gradY [in] Signed gradients in y
+	* \param dst [out] Resulting magnitudes sqrt(gx^2 + gy^2) (truncated)
+	* \param count [in] Number of pixels
+	*/
+	void magnitudeRow(const schar* gradX, const schar* gradY, uchar* dst, int count) {
+		int x = 0;
+
+#ifdef IP_SIMD_X86
+		SimdLevel level = getSimdLevel();
+		if (level >= SIMD_AVX2)
+			x = magnitudeRowAvx2(gradX, gradY, dst, count);
+		else if (level >= SIMD_SSE2)
+			x = magnitudeRowSse2(gradX, gradY, dst, count);
+#endif
+
+		// Scalar reference (and remaining pixels)
+		for (; x < count; x++) {
+			int gx = (int)gradX[x], gy = (int)gradY[x];
+			dst[x] = (uchar)(sqrt(gx * gx + gy * gy));
+		}
+	}
+
+	/*! Map pixel values by a lookup table (point operation).
+	*
+	* SSE2 lacks byte shuffles, so only AVX2 has a vectorized path.
+	*
+	* \param src [in] Source pixels
+	* \param dst [out] Resulting pixels lut[src] (may be src)
+	* \param count [in] Number of pixels
+	* \param lut [in] Lookup table
+	*/
+	void lookupRow(const uchar* src, uchar* dst, int count, const uchar lut[256]) {
+		int x = 0;
+
+#ifdef IP_SIMD_X86
+		if (getSimdLevel() >= SIMD_AVX2)
+			x = lookupRowAvx2(src, dst, count, lut);
+#endif
+
+		// Scalar reference (and remaining pixels)
+		for (; x < count; x++)
+			dst[x] = lut[src[x]];
+	}
+
+	/*! Collect the columns of nonzero pixels of a row (e. g., edge pixels of a binary edge image).
+	*
+	* \param src [in] Source pixels
+	* \param count [in] Number of pixels
+	* \param columns [out] Columns of nonzero pixels in ascending order (room for count entries)
+	* \return number of nonzero pixels
+	*/
+	int nonZeroColumns(const uchar* src, int count, int* columns) {
+		int numColumns = 0, x = 0;
+
+#ifdef IP_SIMD_X86
+		SimdLevel level = getSimdLevel();
+		if (level >= SIMD_AVX2)
+			x = nonZeroColumnsAvx2(src, count, columns, numColumns);
+		else if (level >= SIMD_SSE2)
+			x = nonZeroColumnsSse2(src, count, columns, numColumns);
+#endif
+
+		// Scalar reference (and remaining pixels)
+		for (; x < count; x++) {
+			if (src[x])
+				columns[numColumns++] = x;
+		}
+		return numColumns;
+	}
+}
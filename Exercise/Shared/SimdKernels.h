@@ -0,0 +1,27 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_SIMD_KERNELS_H
+#define IP_SIMD_KERNELS_H
+
+/* Include files */
+#include <opencv2/core/core.hpp>
+#include "Simd.h"
+
+namespace ip
+{
+	void binomialRow3x3(const uchar* above, const uchar* center, const uchar* below, uchar* dst, int count);
+	void binomialRow121(const uchar* first, const uchar* second, const uchar* third, uchar* dst, int count);
+	void minMaxRows(const uchar* minA, const uchar* minB, const uchar* maxA, const uchar* maxB, uchar* minDst, uchar* maxDst, int count);
+	void halfDifferenceRow(const uchar* first, const uchar* second, schar* dst, int count);
+	void magnitudeRow(const schar* gradX, const schar* gradY, uchar* dst, int count);
+	void lookupRow(const uchar* src, uchar* dst, int count, const uchar lut[256]);
+	int nonZeroColumns(const uchar* src, int count, int* columns);
+}
+
+#endif /* IP_SIMD_KERNELS_H */
@@ -0,0 +1,172 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+/* Include files */
+#include <cmath>
+#include <iostream>
+#include "StreamingHistogram.h"
+
+/* Namespaces */
+using namespace std;
+
+namespace ip
+{
+	/*! Remove all pixels. */
+	void StreamingHistogram::clear() {
+		for (int i = 0; i < HISTOGRAM_BINS; i++)
+			bins[i] = 0;
+		for (int i = 0; i < HISTOGRAM_BINS / STREAMING_HISTOGRAM_BLOCK; i++)
+			blocks[i] = 0;
+		total = 0;
+		sum = 0;
+	}
+
+	/*! Add or remove the pixels of an image region.
+	*
+	* Small regions (e. g., a row or column of a sliding window) update the bins pixel by pixel.
+	* Larger regions (e. g., tiles) are counted into a histogram first, which is then added at once.
+	*
+	* \param region Image region (8-bit grayscale, e. g., image.row(y), image.col(x) or image(rect))
+	* \param isAdding Add pixels, if true, remove them otherwise
+	*/
+	void StreamingHistogram::update(const cv::Mat& region, bool isAdding) {
+		// Check for correct image type (8-bit grayscale)
+		if (region.type() != CV_8U) {
+			cout << "[WARNING] Incorrect image type. CV_8U expected." << endl;
+			return;
+		}
+
+		if (region.total() < HISTOGRAM_BINS) {
+			for (int y = 0; y < region.rows; y++) {
+				const uchar* data = region.ptr<uchar>(y);
+
+				for (int x = 0; x < region.cols; x++) {
+					if (isAdding)
+						add(data[x]);
+					else
+						remove(data[x]);
+				}
+			}
+		}
+		else {
+			unsigned histogram[HISTOGRAM_BINS];
+
+			countHistogram(region, histogram);
+			if (isAdding)
+				add(histogram);
+			else
+				remove(histogram);
+		}
+	}
+
+	/*! Add the pixels of an image region.
+	*
+	* \param region Image region (8-bit grayscale)
+	*/
+	void StreamingHistogram::add(const cv::Mat& region) {
+		update(region, true);
+	}
+
+	/*! Remove the pixels of an image region (which must have been added before).
+	*
+	* \param region Image region (8-bit grayscale)
+	*/
+	void StreamingHistogram::remove(const cv::Mat& region) {
+		update(region, false);
+	}
+
+	/*! Add the pixels counted in a histogram (e. g., of a neighboring tile).
+	*
+	* \param histogram Histogram to add
+	*/
+	void StreamingHistogram::add(const unsigned histogram[HISTOGRAM_BINS]) {
+		for (int i = 0; i < HISTOGRAM_BINS; i++) {
+			bins[i] += histogram[i];
+			blocks[i / STREAMING_HISTOGRAM_BLOCK] += histogram[i];
+			total += histogram[i];
+			sum += (uint64_t)i * histogram[i];
+		}
+	}
+
+	/*! Remove the pixels counted in a histogram (which must have been added before).
+	*
+	* \param histogram Histogram to remove
+	*/
+	void StreamingHistogram::remove(const unsigned histogram[HISTOGRAM_BINS]) {
+		for (int i = 0; i < HISTOGRAM_BINS; i++) {
+			bins[i] -= histogram[i];
+			blocks[i / STREAMING_HISTOGRAM_BLOCK] -= histogram[i];
+			total -= histogram[i];
+			sum -= (uint64_t)i * histogram[i];
+		}
+	}
+
+	/*! Number of pixels with values <= value.
+	*
+	* \param value Pixel value in [0, 255]
+	* \return cumulative histogram at value
+	*/
+	unsigned StreamingHistogram::cumulative(int value) const {
+		int block = value / STREAMING_HISTOGRAM_BLOCK;
+		unsigned count = 0;
+
+		for (int i = 0; i < block; i++)
+			count += blocks[i];
+		for (int i = block * STREAMING_HISTOGRAM_BLOCK; i <= value; i++)
+			count += bins[i];
+		return count;
+	}
+
+	/*! Smallest pixel value with at least count pixels <= value.
+	*
+	* \param count Number of pixels (1 .. count())
+	* \return smallest value with cumulative(value) >= count (255 if count > count())
+	*/
+	int StreamingHistogram::valueAtCount(unsigned count) const {
+		unsigned cumulated = 0;
+		int block = 0;
+
+		// Find block, then bin inside block
+		while ((block < HISTOGRAM_BINS / STREAMING_HISTOGRAM_BLOCK - 1) && (cumulated + blocks[block] < count))
+			cumulated += blocks[block++];
+
+		int value = block * STREAMING_HISTOGRAM_BLOCK;
+
+		cumulated += bins[value];
+		while ((value < HISTOGRAM_BINS - 1) && (cumulated < count))
+			cumulated += bins[++value];
+		return value;
+	}
+
+	/*! Pixel value below or at which a fraction q of the pixels lies.
+	*
+	* \param q Fraction in [0.0, 1.0] (0.5: median)
+	* \return smallest value with cumulative(value) >= q * count() (at least one pixel)
+	*/
+	int StreamingHistogram::quantile(double q) const {
+		unsigned count = (unsigned)ceil(q * total);
+
+		return valueAtCount((count > 0) ? count : 1);
+	}
+
+	/*! Copy histogram.
+	*
+	* \param histogram [out] Histogram
+	*/
+	void StreamingHistogram::getHistogram(unsigned histogram[HISTOGRAM_BINS]) const {
+		for (int i = 0; i < HISTOGRAM_BINS; i++)
+			histogram[i] = bins[i];
+	}
+
+	/*! Calculate cumulative histogram.
+	*
+	* \param cumulative [out] Cumulative histogram
+	*/
+	void StreamingHistogram::getCumulative(unsigned cumulative[HISTOGRAM_BINS]) const {
+		cumulateHistogram(bins, cumulative);
+	}
+}
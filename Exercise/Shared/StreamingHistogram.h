@@ -0,0 +1,84 @@
+/*! Digital image processing using OpenCV.
+*
+* \category Excercise Code
+* \author Suman Kafle
+*/
+
+
+#pragma once
+#ifndef IP_STREAMING_HISTOGRAM_H
+#define IP_STREAMING_HISTOGRAM_H
+
+/* Include files */
+#include <cstdint>						// Declare uint64_t
+#include <opencv2/core/core.hpp>
+#include "HistogramKernel.h"
+
+/* Defines */
+#define STREAMING_HISTOGRAM_BLOCK 16	// Bins per coarse block (coarse histogram has 256 / 16 blocks)
+
+namespace ip
+{
+	/*! Histogram of an 8-bit grayscale image region which is updated incrementally.
+	*
+	* Pixels of rows, columns or tiles (any cv::Mat region) are added and removed as a window
+	* slides over an image or a video, without counting the remaining pixels again. Besides
+	* the 256 bins, a coarse histogram of 16 blocks and the sum of pixel values are kept up to
+	* date, so cumulative counts and quantiles are found in at most 32 steps and the mean in O(1).
+	*/
+	class StreamingHistogram {
+	public:
+		StreamingHistogram() { clear(); }
+		explicit StreamingHistogram(const cv::Mat& region) { clear(); add(region); }
+		void clear();
+
+		inline void add(uchar value);
+		inline void remove(uchar value);
+		void add(const cv::Mat& region);
+		void remove(const cv::Mat& region);
+		void add(const unsigned histogram[HISTOGRAM_BINS]);
+		void remove(const unsigned histogram[HISTOGRAM_BINS]);
+
+		unsigned count() const { return total; }
+		unsigned operator[](int value) const { return bins[value]; }
+		unsigned cumulative(int value) const;
+		int valueAtCount(unsigned count) const;
+		int quantile(double q) const;
+		double mean() const { return (total > 0) ? ((double)sum / total) : 0.0; }
+
+		void getHistogram(unsigned histogram[HISTOGRAM_BINS]) const;
+		void getCumulative(unsigned cumulative[HISTOGRAM_BINS]) const;
+
+	private:
+		void update(const cv::Mat& region, bool isAdding);
+
+		unsigned bins[HISTOGRAM_BINS];
+		unsigned blocks[HISTOGRAM_BINS / STREAMING_HISTOGRAM_BLOCK];
+		unsigned total;
+		uint64_t sum;
+	};
+
+	/*! Add a single pixel value.
+	*
+	* \param value Pixel value
+	*/
+	inline void StreamingHistogram::add(uchar value) {
+		bins[value]++;
+		blocks[value / STREAMING_HISTOGRAM_BLOCK]++;
+		total++;
+		sum += value;
+	}
+
+	/*! Remove a single pixel value (which must have been added before).
+	*
+	* \param value Pixel value
+	*/
+	inline void StreamingHistogram::remove(uchar value) {
+		bins[value]--;
+		blocks[value / STREAMING_HISTOGRAM_BLOCK]--;
+		total--;
+		sum -= value;
+	}
+}
+
+#endif /* IP_STREAMING_HISTOGRAM_H */
@@ -12,6 +12,8 @@
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc.hpp>
+#include "BinomialFilter.h"
+#include "Parallel.h"
 
 /* Defines */
 #define IMAGE_DATA_PATH getenv("ImagingData")		// Read environment variable ImagingData
@@ -20,6 +22,8 @@
 #define WINDOW_NAME "Unsharp masking"
 #define TRACKBAR_NAME_ALPHA "Alpha"
 #define INITIAL_ALPHA_PERCENT 100
+#define SPLIT_MARKER_THICKNESS 2
+#define LOW_PASS_KERNEL_SIZE 9		// Binomial kernel size (odd, at most 15)
 
 /* Namespaces */
 using namespace std;
@@ -28,6 +32,7 @@ using namespace std;
 void onTrackbarAlpha(int alphaPercent, void* imagePtr);
 void onMouseSplitScreen(int event, int x, int y, int flags, void* imagePtr);
 void processAndDisplay(cv::Mat image, int alphaPercent, int splitScreenX = -1);
+void renderSplitColumns(const cv::Mat& image, const cv::Mat& processed, cv::Mat& splitImageRGB, int splitX, int beginX, int endX);
 void unsharpMasking(const cv::Mat& source, cv::Mat& processed, double alpha);
 
 /* Main function */
@@ -93,6 +98,9 @@ void onMouseSplitScreen(int event, int x, int y, int flags, void* imagePtr) {
 /*! Apply unsharp masking and display result in split image.
 * 
 * The displayed image is displayed as a split image (left part: processed, right part: not processed).
+* The colored split image is retained between calls. Moving the split position only re-renders the
+* columns between the old and the new position and the old marker line, i. e. O(rows x dx) instead
+* of O(rows x cols). The processed part is re-rendered when alpha changes.
 * 
 * \param image Source image to process
 * \param alphaPercent Masking factor alpha in percent [0, 100]
@@ -101,33 +109,103 @@ void onMouseSplitScreen(int event, int x, int y, int flags, void* imagePtr) {
 void processAndDisplay(cv::Mat image, int alphaPercent, int splitScreenX) {
 	static int lastAlphaPercent = -1;
 	static int splitX = 0;
+	static int markerX = -1;
 	static cv::Mat sharpenedImage, splitImageRGB;
+	int lastSplitX = splitX;
 
 	// Adapt slip position
 	if ((splitScreenX >= 0) && (splitScreenX < image.cols))
 		splitX = splitScreenX;
 
-	// Apply unsharp masking
+	// (Re)create retained split image
+	if ((splitImageRGB.rows != image.rows) || (splitImageRGB.cols != image.cols)) {
+		splitImageRGB.create(image.rows, image.cols, CV_8UC3);
+		lastAlphaPercent = -1;
+		markerX = -1;
+		renderSplitColumns(image, image, splitImageRGB, 0, 0, image.cols);
+	}
+
+	// Apply unsharp masking and re-render processed part
 	if (alphaPercent != lastAlphaPercent) {
 		lastAlphaPercent = alphaPercent;
 		unsharpMasking(image, sharpenedImage, alphaPercent / 100.0);
+		renderSplitColumns(image, sharpenedImage, splitImageRGB, splitX, 0, max(lastSplitX, splitX));
 	}
 
-	// Create gray-valued split image (left: unsharp masking, right: not processed)
-	cv::Mat splitImage = image.clone();
-	cv::Mat srcROI = sharpenedImage.colRange(0, splitX);
-	cv::Mat dstROI = splitImage.colRange(0, splitX);
-	srcROI.copyTo(dstROI);
+	// Re-render columns between old and new split position
+	renderSplitColumns(image, sharpenedImage, splitImageRGB, splitX, min(lastSplitX, splitX), max(lastSplitX, splitX));
+
+	// Remove old and draw new colored split position
+	if (markerX >= 0)
+		renderSplitColumns(image, sharpenedImage, splitImageRGB, splitX, markerX - SPLIT_MARKER_THICKNESS, markerX + SPLIT_MARKER_THICKNESS + 1);
+	markerX = splitX;
+	cv::line(splitImageRGB, cv::Point(splitX, 0), cv::Point(splitX, image.rows - 1), cv::Scalar(0, 0, 255), SPLIT_MARKER_THICKNESS);
 
-	// Create and display RGB image with colored split position
-	cv::cvtColor(splitImage, splitImageRGB, cv::COLOR_GRAY2BGR);
-	cv::line(splitImageRGB, cv::Point(splitX, 0), cv::Point(splitX, splitImage.rows - 1), cv::Scalar(0, 0, 255), 2);
 	cv::imshow(WINDOW_NAME, splitImageRGB);
 }
 
+/*! Render columns of the colored split image.
+* 
+* Columns left of the split position are taken from the processed image, the others from the source image.
+* 
+* \param image Source image (8-bit grayscale)
+* \param processed Processed image (8-bit grayscale, size of source image)
+* \param splitImageRGB Colored split image to update (CV_8UC3, size of source image)
+* \param splitX Image split x coordinate
+* \param beginX First column to render (clipped to image)
+* \param endX Column behind the last column to render (clipped to image)
+*/
+void renderSplitColumns(const cv::Mat& image, const cv::Mat& processed, cv::Mat& splitImageRGB, int splitX, int beginX, int endX) {
+	beginX = max(beginX, 0);
+	endX = min(endX, image.cols);
+
+	for (int y = 0; y < image.rows; y++) {
+		const uchar* srcRow = image.ptr<uchar>(y);
+		const uchar* processedRow = processed.ptr<uchar>(y);
+		cv::Vec3b* dstRow = splitImageRGB.ptr<cv::Vec3b>(y);
+
+		for (int x = beginX; x < endX; x++) {
+			uchar value = (x < splitX) ? processedRow[x] : srcRow[x];
+
+			dstRow[x] = cv::Vec3b(value, value, value);
+		}
+	}
+}
+
+/*! Apply fused low-pass filter and unsharp masking to a band of rows.
+* 
+* The binomial filter streams the low-pass rows of the band (ip::binomialFilterRows()), and
+* the sharpening blend is applied to each row right away, so the low-pass image is never
+* stored. Bands can be processed in parallel.
+* 
+* \param source Source image (8-bit grayscale, not the destination image)
+* \param processed Destination image (allocated with size of source image)
+* \param alphaQ8 Masking factor alpha in Q8 fixed point [0, 256]
+* \param rowBegin First row of the band
+* \param rowEnd Row behind the last row of the band
+*/
+static void unsharpMaskingRows(const cv::Mat& source, cv::Mat& processed, int alphaQ8, int rowBegin, int rowEnd) {
+	int sourceWeight = 256 + alphaQ8;
+
+	ip::binomialFilterRows(source, LOW_PASS_KERNEL_SIZE, rowBegin, rowEnd, [&](int y, const uchar* lowPassRow) {
+		const uchar* srcRow = source.ptr<uchar>(y);
+		uchar* dstRow = processed.ptr<uchar>(y);
+
+		// Blend (1 + alpha) * source - alpha * lowpass in Q8 with rounding and saturation
+		for (int x = 0; x < source.cols; x++) {
+			int value = (sourceWeight * srcRow[x] - alphaQ8 * lowPassRow[x] + 128) >> 8;
+
+			dstRow[x] = (uchar)((value < 0) ? 0 : ((value > 255) ? 255 : value));
+		}
+	});
+}
+
 /*! Apply unsharp masking for image sharpening.
 * 
-* A 9x9 binomial filter is applied as low-pass filter.
+* A 9x9 binomial filter is applied as low-pass filter (integer weights, ip::binomialFilterRows()).
+* Low-pass filter and blend (1 + alpha) * source - alpha * lowpass run fused in one streaming
+* pass with alpha in Q8 fixed point, no floating point image temporaries are created.
+* Bands of rows are processed in parallel (ip::parallelRows()).
 * 
 * \param source Source image to be sharpened (8-bit grayscale)
 * \param processed Resulting sharpened image
@@ -144,14 +222,14 @@ void unsharpMasking(const cv::Mat& source, cv::Mat& processed, double alpha) {
 		return;
 	}
 
-	// Create low-pass kernel (binomial)
-	cv::Mat kernelLP = (cv::Mat_<double>(9, 1) << 1, 8, 28, 56, 70, 56, 28, 8, 1);
-	kernelLP /= cv::sum(kernelLP);
+	// Keep source intact when processing in place
+	cv::Mat image = (source.data == processed.data) ? source.clone() : source;
+	processed.create(image.rows, image.cols, CV_8U);
 
-	// Apply low-pass filter
-	cv::Mat imageLP;
-	cv::sepFilter2D(source, imageLP, source.depth(), kernelLP, kernelLP);
+	// Process bands of rows in parallel (bands of at least the kernel size)
+	int alphaQ8 = cvRound(alpha * 256.0);
 
-	// Apply unsharp masking
-	processed = (1.0 + alpha) * source - alpha * imageLP;
+	ip::parallelRows(image.rows, LOW_PASS_KERNEL_SIZE / 2, [&](const ip::RowBand& band) {
+		unsharpMaskingRows(image, processed, alphaQ8, band.rowBegin, band.rowEnd);
+	}, LOW_PASS_KERNEL_SIZE);
 }
@@ -50,9 +50,8 @@ int main()
 	}
 	imageClone = image.clone();		// Keep copy for reset (remove drawn lines)
 
-	// Calculate edge image
-	sobelFilter(image, sobelImage);
-	cv::threshold(sobelImage, edgeImage, EDGE_IMAGE_THRESHOLD, 255, cv::THRESH_BINARY);
+	// Calculate Sobel and edge image (single pass)
+	sobelFilter(image, sobelImage, SOBEL_L2, NULL, &edgeImage, EDGE_IMAGE_THRESHOLD);
 
 	// Calculate Hough transform and prepare Hough image for display
 	createHoughImage();
@@ -106,6 +105,7 @@ void createHoughImage() {
 * \param imagePtr Source image to process
 */
 void onTrackbarThreshold(int thresh, void* notUsed) {
+	// Threshold the kept Sobel image (cheaper than filtering again)
 	cv::threshold(sobelImage, edgeImage, thresh, 255, cv::THRESH_BINARY);
 	createHoughImage();
 	imageClone.copyTo(image);	// Remove lines drawn
@@ -10,11 +10,18 @@
 
 /* Include files */
 #include <opencv2/core/core.hpp>
+#include "EdgeList.h"
 
 namespace ip
 {
+	/* Datatypes */
+	enum SobelNorm {
+		SOBEL_L1,		// (|gx| + |gy|) / 8 in [0, 255]
+		SOBEL_L2		// sqrt(gx^2 + gy^2) / 8 in [0, 180]
+	};
+
 	/* Prototypes */
-	void sobelFilter(const cv::Mat& image, cv::Mat& sobel);
+	void sobelFilter(const cv::Mat& image, cv::Mat& sobel, SobelNorm norm = SOBEL_L2, cv::Mat* direction = NULL, cv::Mat* edgeImage = NULL, uchar threshold = 0, EdgeList* edgeList = NULL);
 }
 
 #endif /* IP_SOBEL_H */
@@ -7,6 +7,7 @@
 /* Include files */
 #include <opencv2/imgproc/imgproc.hpp>
 #include "DiceDetection.h"
+#include "HistogramKernel.h"
 
 /* Namespaces */
 using namespace std;
@@ -100,11 +101,12 @@ namespace ip
 		ip::labelRegions(labeledImage, pips);
 
 		// Remove regions without very dark pixels and/or bounding box not (almost) squared
+		uchar pixelLimit = getValueInDynamicRange(image, 5);
+
 		for (int i = (int)pips.size() - 1; i >= 0; i--) {
 			ip::blob blob = pips.at(i);
 			cv::Rect2i box = blob.boundingBox;
 			uchar pixelMin = ip::minBlobPixel(image, labeledImage, blob.label);
-			uchar pixelLimit = getValueInDynamicRange(image, 5);
 			double ratio = (box.width < box.height) ? (box.width / (double)box.height) : (box.height / (double)box.width);
 
 			if ((pixelMin > pixelLimit) || (ratio < 0.75)) {
@@ -126,4 +128,37 @@ namespace ip
 		cv::minMaxLoc(image, &pixelMin, &pixelMax);
 		return (uchar)(pixelMin + (percentage / 100.0) * (pixelMax - pixelMin));
 	}
+
+	/*! Get the gray value corresponding to p% of the dynamic range [min, max] of a sample of the pixels.
+	*
+	* Real-time variant for camera frames: Only every stride-th pixel of every stride-th row is
+	* counted (stride 4: 1/16 of the pixels), which may miss isolated extreme pixels (noise).
+	*
+	* \param image [in] Input image (type CV_U8)
+	* \param percentage [in] Percentage p in [0, 100]
+	* \param stride [in] Sampling stride in x and y
+	* \return min + p/100 * (max - min) of the sampled pixels
+	*/
+	uchar getValueInDynamicRange(const cv::Mat& image, int percentage, int stride) {
+		unsigned histogram[HISTOGRAM_BINS];
+
+		countHistogram(image, histogram, stride);
+		return getValueInDynamicRange(histogram, percentage);
+	}
+
+	/*! Get the gray value corresponding to p% of the dynamic range [min, max] of a histogram.
+	*
+	* \param histogram [in] Histogram (e. g., sampled and/or smoothed)
+	* \param percentage [in] Percentage p in [0, 100]
+	* \return min + p/100 * (max - min) with min, max the lowest and highest occupied bins
+	*/
+	uchar getValueInDynamicRange(const unsigned histogram[256], int percentage) {
+		int pixelMin = 0, pixelMax = 255;
+
+		while ((pixelMin < 255) && (histogram[pixelMin] == 0))
+			pixelMin++;
+		while ((pixelMax > pixelMin) && (histogram[pixelMax] == 0))
+			pixelMax--;
+		return (uchar)(pixelMin + (percentage / 100.0) * (pixelMax - pixelMin));
+	}
 }
\ No newline at end of file
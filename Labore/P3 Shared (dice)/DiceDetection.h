@@ -22,6 +22,8 @@ namespace ip
 	void locateDicePips(const cv::Mat& image, cv::Mat& labeledImage, vector<ip::blob>& pips, int threshPercent = 40, int morphSize = 5);
 
 	uchar getValueInDynamicRange(const cv::Mat& image, int percentage);
+	uchar getValueInDynamicRange(const cv::Mat& image, int percentage, int stride);
+	uchar getValueInDynamicRange(const unsigned histogram[256], int percentage);
 }
 
 #endif /* IP_DICE_DETECTION_H */